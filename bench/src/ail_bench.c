@@ -0,0 +1,287 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Times the main APIs over synthetic corpora of several sizes.
+ * The apps are added as org.ailbench.<n> to the App Info DB and removed at the end,
+ * other apps of the DB stay and weigh on the results, so run it on an empty DB to compare runs.
+ * Each measurement is printed as a line of JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "ail.h"
+#include "corpus.h"
+
+#define BENCH_PREFIX "org.ailbench"
+#define BENCH_LOOKUPS 10000
+#define BENCH_UPDATES 1000
+#define BENCH_COUNTS 100
+#define BENCH_FOREACHES 20
+
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+
+static void _report(const char *bench, int apps, int ops, double seconds)
+{
+	printf("{\"bench\":\"%s\",\"apps\":%d,\"ops\":%d,\"total_us\":%.0f,\"us_per_op\":%.2f}\n",
+			bench, apps, ops, seconds * 1e6, seconds * 1e6 / ops);
+	fflush(stdout);
+}
+
+
+
+static int _bench_add(int apps)
+{
+	char package[64];
+	double start;
+	int i;
+
+	start = _now();
+	ail_desktop_batch_begin();
+	for (i = 0; i < apps; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, i);
+		if (ail_desktop_add(package) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot add %s\n", package);
+			ail_desktop_batch_end();
+			return -1;
+		}
+	}
+	ail_desktop_batch_end();
+	_report("desktop_add", apps, apps, _now() - start);
+
+	return 0;
+}
+
+
+
+static int _bench_update(int apps)
+{
+	char package[64];
+	double start;
+	int ops = apps < BENCH_UPDATES ? apps : BENCH_UPDATES;
+	int i;
+
+	start = _now();
+	ail_desktop_batch_begin();
+	for (i = 0; i < ops; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, rand() % apps);
+		if (ail_desktop_update(package) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot update %s\n", package);
+			ail_desktop_batch_end();
+			return -1;
+		}
+	}
+	ail_desktop_batch_end();
+	_report("desktop_update", apps, ops, _now() - start);
+
+	return 0;
+}
+
+
+
+static int _bench_get_appinfo(int apps)
+{
+	char package[64];
+	ail_appinfo_h handle;
+	double start;
+	int i;
+
+	start = _now();
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, rand() % apps);
+		if (ail_get_appinfo(package, &handle) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot get %s\n", package);
+			return -1;
+		}
+		ail_destroy_appinfo(handle);
+	}
+	_report("get_appinfo", apps, BENCH_LOOKUPS, _now() - start);
+
+	return 0;
+}
+
+
+
+static int _bench_filter_count(int apps)
+{
+	ail_filter_h filter;
+	double start;
+	int count;
+	int i;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return -1;
+	ail_filter_add_str(filter, AIL_PROP_CATEGORIES_STR, "Audio");
+
+	start = _now();
+	for (i = 0; i < BENCH_COUNTS; i++) {
+		if (ail_filter_count_appinfo(filter, &count) != AIL_ERROR_OK) {
+			ail_filter_destroy(filter);
+			return -1;
+		}
+	}
+	_report("filter_count", apps, BENCH_COUNTS, _now() - start);
+
+	ail_filter_destroy(filter);
+
+	return 0;
+}
+
+
+
+static ail_cb_ret_e _foreach_cb(const ail_appinfo_h appinfo, void *user_data)
+{
+	char *name;
+
+	if (ail_appinfo_get_str(appinfo, AIL_PROP_NAME_STR, &name) == AIL_ERROR_OK)
+		(*(int *)user_data)++;
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+static int _bench_filter_foreach(int apps)
+{
+	ail_filter_h filter;
+	double start;
+	int rows = 0;
+	int i;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return -1;
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+
+	start = _now();
+	for (i = 0; i < BENCH_FOREACHES; i++) {
+		if (ail_filter_list_appinfo_foreach(filter, _foreach_cb, &rows) != AIL_ERROR_OK) {
+			ail_filter_destroy(filter);
+			return -1;
+		}
+	}
+	_report("filter_foreach", apps, BENCH_FOREACHES, _now() - start);
+
+	ail_filter_destroy(filter);
+
+	return 0;
+}
+
+
+
+static void _cleanup(int apps)
+{
+	char package[64];
+	double start;
+	int i;
+
+	start = _now();
+	ail_desktop_batch_begin();
+	for (i = 0; i < apps; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, i);
+		ail_desktop_remove(package);
+	}
+	ail_desktop_batch_end();
+	_report("desktop_remove", apps, apps, _now() - start);
+}
+
+
+
+static int _bench(int apps, unsigned int seed)
+{
+	int ret = -1;
+
+	if (corpus_write(CORPUS_DIRECTORY, BENCH_PREFIX, apps, seed) < 0)
+		goto out;
+
+	srand(seed);
+	if (_bench_add(apps) < 0
+			|| _bench_update(apps) < 0
+			|| _bench_get_appinfo(apps) < 0
+			|| _bench_filter_count(apps) < 0
+			|| _bench_filter_foreach(apps) < 0)
+		goto cleanup;
+
+	ret = 0;
+
+cleanup:
+	_cleanup(apps);
+out:
+	corpus_remove(CORPUS_DIRECTORY, BENCH_PREFIX, apps);
+
+	return ret;
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	static const int sizes[] = { 100, 1000, 10000 };
+	unsigned int seed = 1;
+	int apps;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "s:h")) != -1) {
+		switch (opt) {
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-s seed] [apps...]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	/* Measure the database, not the caches in front of it */
+	ail_cache_disable();
+	ail_snapshot_disable();
+
+	if (optind < argc) {
+		for (i = optind; i < argc; i++) {
+			apps = atoi(argv[i]);
+			if (apps <= 0 || _bench(apps, seed) < 0)
+				return 1;
+		}
+	} else {
+		for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+			if (_bench(sizes[i], seed) < 0)
+				return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Writes a synthetic corpus of .desktop files, for loading with ail_initdb or ail_desktop_add().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "corpus.h"
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-p prefix] [-s seed] count [directory]\n"
+			"Without a directory, the files go to a new one under /tmp, which is printed.\n", name);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	char tmp[] = "/tmp/ail-corpus-XXXXXX";
+	const char *prefix = "org.ailbench";
+	const char *dir;
+	unsigned int seed = 1;
+	int count;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:s:h")) != -1) {
+		switch (opt) {
+		case 'p':
+			prefix = optarg;
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || (count = atoi(argv[optind])) <= 0) {
+		_usage(argv[0]);
+		return 1;
+	}
+
+	if (optind + 1 < argc) {
+		dir = argv[optind + 1];
+	} else {
+		dir = mkdtemp(tmp);
+		if (!dir) {
+			perror("mkdtemp");
+			return 1;
+		}
+	}
+
+	if (corpus_write(dir, prefix, count, seed) < 0)
+		return 1;
+
+	printf("%s\n", dir);
+
+	return 0;
+}
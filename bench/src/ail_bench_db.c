@@ -0,0 +1,169 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Times appinfo lookups and bulk desktop adds under several ail_db_config() tunings.
+ * The apps are added as org.ailbench.<n> to the App Info DB and removed at the end.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "ail.h"
+#include "corpus.h"
+
+#define BENCH_PREFIX "org.ailbench"
+
+static const struct {
+	const char *name;
+	ail_db_config_s config;
+} tunings[] = {
+	{ "default", { 0, } },
+	{ "cache_size_kb=64", { .cache_size_kb = 64 } },
+	{ "cache_size_kb=8192", { .cache_size_kb = 8192 } },
+	{ "mmap_size=64M", { .mmap_size = 64 * 1024 * 1024 } },
+	{ "temp_store=memory", { .temp_store = AIL_DB_TEMP_STORE_MEMORY } },
+	{ "synchronous=off", { .synchronous = AIL_DB_SYNCHRONOUS_OFF } },
+	{ "synchronous=normal", { .synchronous = AIL_DB_SYNCHRONOUS_NORMAL } },
+	{ "synchronous=full", { .synchronous = AIL_DB_SYNCHRONOUS_FULL } },
+};
+
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+
+/* Returns the seconds spent adding count apps, or -1 */
+static double _bench_add(int count)
+{
+	char package[64];
+	double start;
+	int i;
+
+	start = _now();
+	ail_desktop_batch_begin();
+	for (i = 0; i < count; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, i);
+		if (ail_desktop_add(package) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot add %s\n", package);
+			ail_desktop_batch_end();
+			return -1;
+		}
+	}
+	ail_desktop_batch_end();
+
+	return _now() - start;
+}
+
+
+
+static double _bench_lookup(int count, int lookups)
+{
+	char package[64];
+	ail_appinfo_h handle;
+	double start;
+	int i;
+
+	start = _now();
+	for (i = 0; i < lookups; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, rand() % count);
+		if (ail_get_appinfo(package, &handle) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot get %s\n", package);
+			return -1;
+		}
+		ail_destroy_appinfo(handle);
+	}
+
+	return _now() - start;
+}
+
+
+
+static void _cleanup(int count)
+{
+	char package[64];
+	int i;
+
+	ail_desktop_batch_begin();
+	for (i = 0; i < count; i++) {
+		corpus_package(package, sizeof(package), BENCH_PREFIX, i);
+		ail_desktop_remove(package);
+	}
+	ail_desktop_batch_end();
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	int count = 500;
+	int lookups = 20000;
+	double add;
+	double lookup;
+	int failed = 0;
+	int i;
+
+	if (argc > 1)
+		count = atoi(argv[1]);
+	if (argc > 2)
+		lookups = atoi(argv[2]);
+	if (count <= 0 || lookups <= 0) {
+		fprintf(stderr, "Usage: %s [apps] [lookups]\n", argv[0]);
+		return 1;
+	}
+
+	if (corpus_write(CORPUS_DIRECTORY, BENCH_PREFIX, count, 1) < 0)
+		return 1;
+
+	/* Measure the database, not the caches in front of it */
+	ail_cache_disable();
+	ail_snapshot_disable();
+
+	printf("%-20s %14s %14s\n", "tuning", "add (us/app)", "lookup (us)");
+	for (i = 0; i < sizeof(tunings) / sizeof(tunings[0]); i++) {
+		ail_db_config(&tunings[i].config);
+
+		add = _bench_add(count);
+		lookup = add < 0 ? -1 : _bench_lookup(count, lookups);
+		_cleanup(count);
+		if (add < 0 || lookup < 0) {
+			failed = 1;
+			break;
+		}
+
+		printf("%-20s %14.1f %14.2f\n", tunings[i].name, add * 1e6 / count, lookup * 1e6 / lookups);
+	}
+
+	corpus_remove(CORPUS_DIRECTORY, BENCH_PREFIX, count);
+
+	return failed;
+}
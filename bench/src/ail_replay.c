@@ -0,0 +1,722 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Replays call traces recorded with AIL_RECORD=<file> against the App Info DB, one thread per
+ * recorded thread, at the recorded pace or as fast as possible, then prints the latency of every
+ * API as lines of JSON next to the recorded one.
+ * The desktop files the trace adds or updates must be where they were when it was recorded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "ail.h"
+#include "ail_record.h"
+
+#ifndef AIL_ROOT
+#define AIL_ROOT ""
+#endif
+
+#define REPLAY_DB AIL_ROOT"/opt/dbspace/.app_info.db"
+
+/* Exported by libail, but not declared in ail.h */
+ail_error_e ail_desktop_appinfo_modify_bool(const char *package, const char *property, bool value);
+
+static const char *api_names[RECORD_API_MAX] = {
+	[RECORD_GET_APPINFO] = "get_appinfo",
+	[RECORD_PACKAGE_GET_APPINFO] = "package_get_appinfo",
+	[RECORD_GET_APPINFO_BY_EXE_PATH] = "get_appinfo_by_exe_path",
+	[RECORD_GET_APPINFO_BY_EXE_PATHS] = "get_appinfo_by_exe_paths",
+	[RECORD_FILTER_COUNT] = "filter_count_appinfo",
+	[RECORD_FILTER_FOREACH] = "filter_list_appinfo_foreach",
+	[RECORD_MIME_GET_HANDLERS] = "mime_get_handlers",
+	[RECORD_CHANGES_SINCE] = "changes_since",
+	[RECORD_DESKTOP_ADD] = "desktop_add",
+	[RECORD_DESKTOP_UPDATE] = "desktop_update",
+	[RECORD_DESKTOP_REMOVE] = "desktop_remove",
+	[RECORD_DESKTOP_MODIFY_BOOL] = "desktop_appinfo_modify_bool",
+	[RECORD_DESKTOP_BATCH_BEGIN] = "desktop_batch_begin",
+	[RECORD_DESKTOP_BATCH_END] = "desktop_batch_end",
+};
+
+struct call {
+	struct record_entry e;
+	const unsigned char *args;
+	uint32_t replayed_us;
+	int32_t ret;
+};
+
+/* The calls of one recorded thread */
+struct thread {
+	pthread_t thread;
+	int trace;
+	uint32_t id;
+	struct call *calls;
+	int n;
+	int size;
+};
+
+/* Arguments of one call, decoded before it is timed */
+struct args {
+	const char *str[2];
+	const char **paths;
+	int n_paths;
+	ail_filter_h filter;
+	int rows;
+	long long seq;
+	int value;
+};
+
+struct cursor {
+	const unsigned char *p;
+	const unsigned char *end;
+	bool bad;
+};
+
+static struct {
+	bool full_speed;
+	uint64_t trace_start;
+	uint64_t replay_start;
+	struct thread *threads;
+	int n_threads;
+} replay;
+
+static uint64_t _now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+
+static int _byte(struct cursor *c)
+{
+	if (c->end - c->p < 1) {
+		c->bad = true;
+		return 0;
+	}
+
+	return *c->p++;
+}
+
+
+
+static int _int(struct cursor *c)
+{
+	int32_t v;
+
+	if (c->end - c->p < (int)sizeof(v)) {
+		c->bad = true;
+		return 0;
+	}
+
+	memcpy(&v, c->p, sizeof(v));
+	c->p += sizeof(v);
+
+	return v;
+}
+
+
+
+static long long _int64(struct cursor *c)
+{
+	int64_t v;
+
+	if (c->end - c->p < (int)sizeof(v)) {
+		c->bad = true;
+		return 0;
+	}
+
+	memcpy(&v, c->p, sizeof(v));
+	c->p += sizeof(v);
+
+	return v;
+}
+
+
+
+static const char *_str(struct cursor *c)
+{
+	const unsigned char *nul;
+	const char *s;
+
+	nul = memchr(c->p, '\0', c->end - c->p);
+	if (!nul) {
+		c->bad = true;
+		return "";
+	}
+
+	s = (const char *)c->p;
+	c->p = nul + 1;
+
+	return s;
+}
+
+
+
+static ail_filter_h _filter(struct cursor *c)
+{
+	ail_filter_h filter;
+	int prop;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return NULL;
+
+	while (c->p < c->end && !c->bad) {
+		switch (_byte(c)) {
+		case RECORD_FILTER_BOOL:
+			prop = _byte(c);
+			ail_filter_add_bool_by_id(filter, prop, _byte(c));
+			break;
+		case RECORD_FILTER_INT:
+			prop = _byte(c);
+			ail_filter_add_int_by_id(filter, prop, _int(c));
+			break;
+		case RECORD_FILTER_STR:
+			prop = _byte(c);
+			ail_filter_add_str_by_id(filter, prop, _str(c));
+			break;
+		case RECORD_FILTER_SEARCH:
+			ail_filter_add_search(filter, _str(c));
+			break;
+		default:
+			c->bad = true;
+		}
+	}
+
+	return filter;
+}
+
+
+
+static bool _decode(const struct call *call, struct args *a)
+{
+	struct cursor c = { call->args, call->args + call->e.len, false };
+	const unsigned char *p;
+
+	memset(a, 0, sizeof(*a));
+
+	switch (call->e.api) {
+	case RECORD_GET_APPINFO:
+	case RECORD_PACKAGE_GET_APPINFO:
+	case RECORD_GET_APPINFO_BY_EXE_PATH:
+	case RECORD_DESKTOP_ADD:
+	case RECORD_DESKTOP_UPDATE:
+	case RECORD_DESKTOP_REMOVE:
+		a->str[0] = _str(&c);
+		break;
+	case RECORD_GET_APPINFO_BY_EXE_PATHS:
+		for (p = c.p; p < c.end; p++)
+			a->n_paths += *p ? 0 : 1;
+		a->paths = calloc(a->n_paths ? a->n_paths : 1, sizeof(char *));
+		if (!a->paths)
+			return false;
+		for (a->n_paths = 0; c.p < c.end; a->n_paths++)
+			a->paths[a->n_paths] = _str(&c);
+		break;
+	case RECORD_FILTER_COUNT:
+		a->filter = _filter(&c);
+		break;
+	case RECORD_FILTER_FOREACH:
+		a->rows = _int(&c);
+		a->filter = _filter(&c);
+		break;
+	case RECORD_MIME_GET_HANDLERS:
+		a->rows = _int(&c);
+		a->str[0] = _str(&c);
+		break;
+	case RECORD_CHANGES_SINCE:
+		a->seq = _int64(&c);
+		break;
+	case RECORD_DESKTOP_MODIFY_BOOL:
+		a->str[0] = _str(&c);
+		a->str[1] = _str(&c);
+		a->value = _byte(&c);
+		break;
+	case RECORD_DESKTOP_BATCH_BEGIN:
+	case RECORD_DESKTOP_BATCH_END:
+		break;
+	default:
+		return false;
+	}
+
+	if (c.bad) {
+		free(a->paths);
+		if (a->filter)
+			ail_filter_destroy(a->filter);
+		return false;
+	}
+
+	return true;
+}
+
+
+
+/* Stops where the recorded callback did */
+static ail_cb_ret_e _rows_cb(const ail_appinfo_h appinfo, void *user_data)
+{
+	int *left = user_data;
+
+	return --(*left) > 0 ? AIL_CB_RET_CONTINUE : AIL_CB_RET_CANCEL;
+}
+
+
+
+static ail_cb_ret_e _change_cb(unsigned long long seq, ail_change_type_e type, const char *package, void *user_data)
+{
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+static ail_error_e _execute(int api, struct args *a)
+{
+	ail_appinfo_h ai;
+	ail_appinfo_h *ais;
+	ail_error_e ret;
+	int n;
+	int i;
+
+	switch (api) {
+	case RECORD_GET_APPINFO:
+		ret = ail_get_appinfo(a->str[0], &ai);
+		break;
+	case RECORD_PACKAGE_GET_APPINFO:
+		ret = ail_package_get_appinfo(a->str[0], &ai);
+		break;
+	case RECORD_GET_APPINFO_BY_EXE_PATH:
+		ret = ail_get_appinfo_by_exe_path(a->str[0], &ai);
+		break;
+	case RECORD_GET_APPINFO_BY_EXE_PATHS:
+		ais = calloc(a->n_paths ? a->n_paths : 1, sizeof(ail_appinfo_h));
+		if (!ais)
+			return AIL_ERROR_OUT_OF_MEMORY;
+		ret = ail_get_appinfo_by_exe_paths(a->paths, a->n_paths, ais);
+		for (i = 0; ret == AIL_ERROR_OK && i < a->n_paths; i++) {
+			if (ais[i])
+				ail_destroy_appinfo(ais[i]);
+		}
+		free(ais);
+		return ret;
+	case RECORD_FILTER_COUNT:
+		return ail_filter_count_appinfo(a->filter, &n);
+	case RECORD_FILTER_FOREACH:
+		return ail_filter_list_appinfo_foreach(a->filter, _rows_cb, &a->rows);
+	case RECORD_MIME_GET_HANDLERS:
+		return ail_mime_get_handlers(a->str[0], _rows_cb, &a->rows);
+	case RECORD_CHANGES_SINCE:
+		return ail_changes_since(a->seq, _change_cb, NULL);
+	case RECORD_DESKTOP_ADD:
+		return ail_desktop_add(a->str[0]);
+	case RECORD_DESKTOP_UPDATE:
+		return ail_desktop_update(a->str[0]);
+	case RECORD_DESKTOP_REMOVE:
+		return ail_desktop_remove(a->str[0]);
+	case RECORD_DESKTOP_MODIFY_BOOL:
+		return ail_desktop_appinfo_modify_bool(a->str[0], a->str[1], a->value);
+	case RECORD_DESKTOP_BATCH_BEGIN:
+		return ail_desktop_batch_begin();
+	case RECORD_DESKTOP_BATCH_END:
+		return ail_desktop_batch_end();
+	default:
+		return AIL_ERROR_INVALID_PARAMETER;
+	}
+
+	if (ret == AIL_ERROR_OK)
+		ail_destroy_appinfo(ai);
+
+	return ret;
+}
+
+
+
+static void *_replay_thread(void *data)
+{
+	struct thread *t = data;
+	struct call *call;
+	struct args a;
+	uint64_t due;
+	uint64_t now;
+	uint64_t start;
+	int i;
+
+	for (i = 0; i < t->n; i++) {
+		call = &t->calls[i];
+
+		if (!_decode(call, &a)) {
+			call->ret = AIL_ERROR_INVALID_PARAMETER;
+			continue;
+		}
+
+		if (!replay.full_speed) {
+			due = replay.replay_start + (call->e.start_us - replay.trace_start);
+			now = _now_us();
+			if (due > now)
+				usleep(due - now);
+		}
+
+		start = _now_us();
+		call->ret = _execute(call->e.api, &a);
+		call->replayed_us = _now_us() - start;
+
+		free(a.paths);
+		if (a.filter)
+			ail_filter_destroy(a.filter);
+	}
+
+	return NULL;
+}
+
+
+
+static struct thread *_thread(int trace, uint32_t id)
+{
+	struct thread *t;
+	int i;
+
+	for (i = 0; i < replay.n_threads; i++) {
+		if (replay.threads[i].trace == trace && replay.threads[i].id == id)
+			return &replay.threads[i];
+	}
+
+	t = realloc(replay.threads, (replay.n_threads + 1) * sizeof(struct thread));
+	if (!t)
+		return NULL;
+	replay.threads = t;
+
+	t = &replay.threads[replay.n_threads++];
+	memset(t, 0, sizeof(*t));
+	t->trace = trace;
+	t->id = id;
+
+	return t;
+}
+
+
+
+/* The calls point into the returned buffer */
+static unsigned char *_load(const char *path, int trace)
+{
+	struct record_header h;
+	struct record_entry e;
+	struct thread *t;
+	struct call *calls;
+	unsigned char *data;
+	size_t off;
+	long size;
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		fprintf(stderr, "Cannot open %s\n", path);
+		return NULL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	rewind(fp);
+
+	data = malloc(size > 0 ? size : 1);
+	if (!data || size < (long)sizeof(h) || fread(data, 1, size, fp) != (size_t)size) {
+		fprintf(stderr, "Cannot read %s\n", path);
+		fclose(fp);
+		free(data);
+		return NULL;
+	}
+	fclose(fp);
+
+	memcpy(&h, data, sizeof(h));
+	if (memcmp(h.magic, RECORD_MAGIC, sizeof(h.magic)) || h.version != RECORD_VERSION) {
+		fprintf(stderr, "%s is not a call trace of this version\n", path);
+		free(data);
+		return NULL;
+	}
+
+	for (off = sizeof(h); off + sizeof(e) <= (size_t)size; off += e.len) {
+		memcpy(&e, data + off, sizeof(e));
+		off += sizeof(e);
+		/* A process killed while writing leaves a short last call */
+		if (off + e.len > (size_t)size)
+			break;
+
+		t = _thread(trace, e.thread);
+		if (!t) {
+			free(data);
+			return NULL;
+		}
+
+		if (t->n == t->size) {
+			t->size = t->size ? t->size * 2 : 256;
+			calls = realloc(t->calls, t->size * sizeof(struct call));
+			if (!calls) {
+				free(data);
+				return NULL;
+			}
+			t->calls = calls;
+		}
+
+		t->calls[t->n].e = e;
+		t->calls[t->n].args = data + off;
+		t->n++;
+
+		if (!replay.trace_start || e.start_us < replay.trace_start)
+			replay.trace_start = e.start_us;
+	}
+
+	return data;
+}
+
+
+
+static int _restore(const char *snapshot)
+{
+	static const char *suffixes[] = { "-journal", "-wal", "-shm" };
+	char path[sizeof(REPLAY_DB) + 16];
+	char buf[64 * 1024];
+	FILE *in;
+	FILE *out;
+	size_t n;
+	int failed = 0;
+	int i;
+
+	in = fopen(snapshot, "r");
+	if (!in) {
+		fprintf(stderr, "Cannot open %s\n", snapshot);
+		return -1;
+	}
+
+	out = fopen(REPLAY_DB, "w");
+	if (!out) {
+		fprintf(stderr, "Cannot write %s\n", REPLAY_DB);
+		fclose(in);
+		return -1;
+	}
+
+	while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+		if (fwrite(buf, 1, n, out) != n) {
+			failed = -1;
+			break;
+		}
+	}
+
+	fclose(in);
+	if (fclose(out))
+		failed = -1;
+
+	for (i = 0; i < (int)(sizeof(suffixes) / sizeof(suffixes[0])); i++) {
+		snprintf(path, sizeof(path), "%s%s", REPLAY_DB, suffixes[i]);
+		unlink(path);
+	}
+
+	/* Caches of every process were filled from the replaced DB */
+	if (!failed && ail_db_invalidate() != AIL_ERROR_OK) {
+		fprintf(stderr, "Cannot move the generation of %s\n", REPLAY_DB);
+		failed = -1;
+	}
+
+	/* Readers must not answer from a snapshot of the replaced DB */
+	ail_snapshot_publish();
+
+	return failed;
+}
+
+
+
+static int _cmp_us(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+
+
+static uint32_t _percentile(const uint32_t *sorted, int n, int permille)
+{
+	int rank = ((long long)n * permille + 999) / 1000;
+
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+
+static void _report(double seconds)
+{
+	uint32_t *recorded;
+	uint32_t *replayed;
+	unsigned long long recorded_total;
+	unsigned long long replayed_total;
+	struct call *call;
+	int mismatches;
+	int calls = 0;
+	int api;
+	int n;
+	int i;
+	int j;
+
+	for (i = 0; i < replay.n_threads; i++)
+		calls += replay.threads[i].n;
+
+	printf("{\"threads\":%d,\"calls\":%d,\"pace\":\"%s\",\"seconds\":%.3f}\n",
+			replay.n_threads, calls, replay.full_speed ? "full" : "recorded", seconds);
+
+	recorded = malloc((calls ? calls : 1) * sizeof(uint32_t));
+	replayed = malloc((calls ? calls : 1) * sizeof(uint32_t));
+	if (!recorded || !replayed) {
+		free(recorded);
+		free(replayed);
+		return;
+	}
+
+	for (api = 1; api < RECORD_API_MAX; api++) {
+		n = 0;
+		mismatches = 0;
+		recorded_total = 0;
+		replayed_total = 0;
+
+		for (i = 0; i < replay.n_threads; i++) {
+			for (j = 0; j < replay.threads[i].n; j++) {
+				call = &replay.threads[i].calls[j];
+				if (call->e.api != api)
+					continue;
+				recorded[n] = call->e.duration_us;
+				replayed[n] = call->replayed_us;
+				recorded_total += call->e.duration_us;
+				replayed_total += call->replayed_us;
+				mismatches += call->ret != call->e.ret ? 1 : 0;
+				n++;
+			}
+		}
+
+		if (!n)
+			continue;
+
+		qsort(recorded, n, sizeof(uint32_t), _cmp_us);
+		qsort(replayed, n, sizeof(uint32_t), _cmp_us);
+
+		printf("{\"api\":\"%s\",\"calls\":%d,\"mismatches\":%d,"
+				"\"mean_us\":%.1f,\"p50_us\":%u,\"p90_us\":%u,\"p99_us\":%u,\"max_us\":%u,"
+				"\"recorded_mean_us\":%.1f,\"recorded_p50_us\":%u,\"recorded_p99_us\":%u,\"recorded_max_us\":%u}\n",
+				api_names[api], n, mismatches,
+				(double)replayed_total / n, _percentile(replayed, n, 500), _percentile(replayed, n, 900),
+				_percentile(replayed, n, 990), replayed[n - 1],
+				(double)recorded_total / n, _percentile(recorded, n, 500),
+				_percentile(recorded, n, 990), recorded[n - 1]);
+	}
+
+	free(recorded);
+	free(replayed);
+}
+
+
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-f] [-d snapshot] trace...\n"
+			"\t-f\treplay as fast as possible instead of at the recorded pace\n"
+			"\t-d\tcopy the DB file snapshot over %s first\n", name, REPLAY_DB);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	const char *snapshot = NULL;
+	unsigned char **data;
+	uint64_t start;
+	int failed = 0;
+	int opt;
+	int i;
+
+	/* Not a trace of the replay */
+	unsetenv("AIL_RECORD");
+
+	while ((opt = getopt(argc, argv, "fd:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			replay.full_speed = true;
+			break;
+		case 'd':
+			snapshot = optarg;
+			break;
+		default:
+			_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc) {
+		_usage(argv[0]);
+		return 1;
+	}
+
+	data = calloc(argc - optind, sizeof(unsigned char *));
+	if (!data)
+		return 1;
+
+	for (i = optind; i < argc; i++) {
+		data[i - optind] = _load(argv[i], i - optind);
+		if (!data[i - optind])
+			return 1;
+	}
+
+	if (snapshot && _restore(snapshot) < 0)
+		return 1;
+
+	start = _now_us();
+	replay.replay_start = start;
+
+	for (i = 0; i < replay.n_threads; i++) {
+		if (pthread_create(&replay.threads[i].thread, NULL, _replay_thread, &replay.threads[i])) {
+			fprintf(stderr, "Cannot start a replay thread\n");
+			failed = 1;
+			replay.n_threads = i;
+			break;
+		}
+	}
+
+	for (i = 0; i < replay.n_threads; i++)
+		pthread_join(replay.threads[i].thread, NULL);
+
+	if (!failed)
+		_report((_now_us() - start) / 1e6);
+
+	for (i = 0; i < replay.n_threads; i++)
+		free(replay.threads[i].calls);
+	free(replay.threads);
+	for (i = 0; i < argc - optind; i++)
+		free(data[i]);
+	free(data);
+
+	return failed;
+}
@@ -0,0 +1,481 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Readers and writers hammering one App Info DB from threads of several processes.
+ * Readers mix ail_get_appinfo() with foreach, writers update apps or remove and add them again,
+ * each writer owning its own apps of the corpus org.ailstress.<n>.
+ * Every use of the library happens in child processes, so no connection crosses a fork().
+ * The results are printed as lines of JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "ail.h"
+#include "corpus.h"
+
+#define STRESS_PREFIX "org.ailstress"
+#define LAT_BUCKETS 32
+
+enum {
+	OP_GET,
+	OP_FOREACH,
+	OP_UPDATE,
+	OP_REPLACE,
+	OP_MAX,
+};
+
+static const char *op_names[OP_MAX] = { "get_appinfo", "foreach", "desktop_update", "desktop_remove_add" };
+
+/* Latencies of one kind of operation */
+struct lat {
+	unsigned long ops;
+	unsigned long errors;
+	unsigned long long total_us;
+	unsigned long long max_us;
+	unsigned long buckets[LAT_BUCKETS];	/* bucket i counts latencies under 2^i us */
+};
+
+struct result {
+	struct lat lat[OP_MAX];
+	ail_busy_stats_s busy;
+};
+
+struct worker {
+	pthread_t thread;
+	int id;			/* among the readers or the writers of all processes */
+	struct result result;
+};
+
+static struct {
+	int readers;
+	int writers;
+	int processes;
+	int seconds;
+	int apps;
+	int interval_ms;	/* pause of the writers between operations */
+	bool caches;
+	unsigned int seed;
+	unsigned long long deadline;
+} cfg = {
+	.readers = 4,
+	.writers = 1,
+	.processes = 1,
+	.seconds = 10,
+	.apps = 200,
+	.interval_ms = 0,
+	.caches = false,
+	.seed = 1,
+};
+
+static unsigned long long _now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+
+static void _record(struct lat *lat, unsigned long long start, bool failed)
+{
+	unsigned long long us = _now_us() - start;
+	int bucket = 0;
+
+	while (bucket < LAT_BUCKETS - 1 && us >= (1ULL << bucket))
+		bucket++;
+
+	lat->ops++;
+	lat->errors += failed ? 1 : 0;
+	lat->total_us += us;
+	if (us > lat->max_us)
+		lat->max_us = us;
+	lat->buckets[bucket]++;
+}
+
+
+
+static void _merge(struct result *to, const struct result *from)
+{
+	int i;
+	int j;
+
+	for (i = 0; i < OP_MAX; i++) {
+		to->lat[i].ops += from->lat[i].ops;
+		to->lat[i].errors += from->lat[i].errors;
+		to->lat[i].total_us += from->lat[i].total_us;
+		if (from->lat[i].max_us > to->lat[i].max_us)
+			to->lat[i].max_us = from->lat[i].max_us;
+		for (j = 0; j < LAT_BUCKETS; j++)
+			to->lat[i].buckets[j] += from->lat[i].buckets[j];
+	}
+
+	to->busy.waits += from->busy.waits;
+	to->busy.retries += from->busy.retries;
+	to->busy.wait_us += from->busy.wait_us;
+	to->busy.timeouts += from->busy.timeouts;
+}
+
+
+
+static ail_cb_ret_e _foreach_cb(const ail_appinfo_h appinfo, void *user_data)
+{
+	char *name;
+
+	ail_appinfo_get_str(appinfo, AIL_PROP_NAME_STR, &name);
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+static void *_reader(void *data)
+{
+	struct worker *w = data;
+	unsigned int seed = cfg.seed + w->id;
+	char package[64];
+	ail_appinfo_h handle;
+	ail_filter_h filter;
+	unsigned long long start;
+	ail_error_e ret;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return NULL;
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+
+	while (_now_us() < cfg.deadline) {
+		start = _now_us();
+		if (rand_r(&seed) % 10 < 8) {
+			corpus_package(package, sizeof(package), STRESS_PREFIX, rand_r(&seed) % cfg.apps);
+			ret = ail_get_appinfo(package, &handle);
+			if (ret == AIL_ERROR_OK)
+				ail_destroy_appinfo(handle);
+			/* A writer may be between its remove and its add */
+			_record(&w->result.lat[OP_GET], start, ret != AIL_ERROR_OK && ret != AIL_ERROR_NO_DATA);
+		} else {
+			ret = ail_filter_list_appinfo_foreach(filter, _foreach_cb, NULL);
+			_record(&w->result.lat[OP_FOREACH], start, ret != AIL_ERROR_OK);
+		}
+	}
+
+	ail_filter_destroy(filter);
+
+	return NULL;
+}
+
+
+
+static void *_writer(void *data)
+{
+	struct worker *w = data;
+	unsigned int seed = cfg.seed + 1000 + w->id;
+	int writers = cfg.writers * cfg.processes;
+	int owned = cfg.apps / writers + (w->id < cfg.apps % writers ? 1 : 0);
+	char package[64];
+	unsigned long long start;
+	bool failed;
+
+	if (!owned)
+		return NULL;
+
+	while (_now_us() < cfg.deadline) {
+		corpus_package(package, sizeof(package), STRESS_PREFIX, w->id + (rand_r(&seed) % owned) * writers);
+
+		start = _now_us();
+		if (rand_r(&seed) % 10 < 6) {
+			failed = ail_desktop_update(package) != AIL_ERROR_OK;
+			_record(&w->result.lat[OP_UPDATE], start, failed);
+		} else {
+			failed = ail_desktop_remove(package) != AIL_ERROR_OK;
+			failed = ail_desktop_add(package) != AIL_ERROR_OK || failed;
+			_record(&w->result.lat[OP_REPLACE], start, failed);
+		}
+
+		if (cfg.interval_ms)
+			usleep(cfg.interval_ms * 1000);
+	}
+
+	return NULL;
+}
+
+
+
+/* Runs the threads of one process and sums their results */
+static void _run_process(int index, struct result *result)
+{
+	struct worker *workers;
+	int n = cfg.readers + cfg.writers;
+	int i;
+
+	memset(result, 0, sizeof(*result));
+
+	workers = calloc(n, sizeof(struct worker));
+	if (!workers)
+		return;
+
+	if (!cfg.caches) {
+		ail_cache_disable();
+		ail_snapshot_disable();
+	}
+	ail_stats_reset();
+
+	for (i = 0; i < n; i++) {
+		if (i < cfg.readers) {
+			workers[i].id = index * cfg.readers + i;
+			pthread_create(&workers[i].thread, NULL, _reader, &workers[i]);
+		} else {
+			workers[i].id = index * cfg.writers + i - cfg.readers;
+			pthread_create(&workers[i].thread, NULL, _writer, &workers[i]);
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		pthread_join(workers[i].thread, NULL);
+		_merge(result, &workers[i].result);
+	}
+
+	ail_stats_get_busy(&result->busy);
+
+	free(workers);
+}
+
+
+
+static int _in_child(void (*fn)(void))
+{
+	pid_t pid;
+	int status;
+
+	pid = fork();
+	if (pid < 0)
+		return -1;
+	if (!pid) {
+		fn();
+		_exit(0);
+	}
+
+	if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status))
+		return -1;
+
+	return 0;
+}
+
+
+
+static void _setup(void)
+{
+	char package[64];
+	int i;
+
+	ail_desktop_batch_begin();
+	for (i = 0; i < cfg.apps; i++) {
+		corpus_package(package, sizeof(package), STRESS_PREFIX, i);
+		if (ail_desktop_add(package) != AIL_ERROR_OK) {
+			fprintf(stderr, "Cannot add %s\n", package);
+			ail_desktop_batch_end();
+			_exit(1);
+		}
+	}
+	ail_desktop_batch_end();
+}
+
+
+
+static void _cleanup(void)
+{
+	char package[64];
+	int i;
+
+	ail_desktop_batch_begin();
+	for (i = 0; i < cfg.apps; i++) {
+		corpus_package(package, sizeof(package), STRESS_PREFIX, i);
+		ail_desktop_remove(package);
+	}
+	ail_desktop_batch_end();
+}
+
+
+
+static unsigned long long _percentile(const struct lat *lat, int permille)
+{
+	unsigned long long rank;
+	unsigned long long seen = 0;
+	int i;
+
+	rank = (lat->ops * permille + 999) / 1000;
+
+	for (i = 0; i < LAT_BUCKETS; i++) {
+		seen += lat->buckets[i];
+		if (seen >= rank)
+			break;
+	}
+
+	return (1ULL << i) < lat->max_us ? (1ULL << i) : lat->max_us;
+}
+
+
+
+static void _report(const struct result *result, double seconds)
+{
+	const struct lat *lat;
+	int i;
+
+	printf("{\"readers\":%d,\"writers\":%d,\"processes\":%d,\"apps\":%d,\"seconds\":%.1f,"
+			"\"busy_waits\":%lu,\"busy_retries\":%lu,\"busy_wait_us\":%llu,\"busy_timeouts\":%lu}\n",
+			cfg.readers, cfg.writers, cfg.processes, cfg.apps, seconds,
+			result->busy.waits, result->busy.retries, result->busy.wait_us, result->busy.timeouts);
+
+	for (i = 0; i < OP_MAX; i++) {
+		lat = &result->lat[i];
+		if (!lat->ops)
+			continue;
+		printf("{\"op\":\"%s\",\"ops\":%lu,\"ops_per_s\":%.1f,\"errors\":%lu,\"mean_us\":%.1f,"
+				"\"p50_us\":%llu,\"p99_us\":%llu,\"p999_us\":%llu,\"max_us\":%llu}\n",
+				op_names[i], lat->ops, lat->ops / seconds, lat->errors, (double)lat->total_us / lat->ops,
+				_percentile(lat, 500), _percentile(lat, 990), _percentile(lat, 999), lat->max_us);
+	}
+}
+
+
+
+static void _usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-r readers] [-w writers] [-p processes] [-d seconds] [-n apps]\n"
+			"\t[-i writer interval ms] [-s seed] [-c]\n"
+			"Threads are per process, -c keeps the appinfo cache and the snapshot enabled.\n", name);
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	struct result total = { { { 0, } } };
+	struct result one;
+	unsigned long long start;
+	int (*fds)[2];
+	pid_t *pids;
+	int failed = 0;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "r:w:p:d:n:i:s:ch")) != -1) {
+		switch (opt) {
+		case 'r':
+			cfg.readers = atoi(optarg);
+			break;
+		case 'w':
+			cfg.writers = atoi(optarg);
+			break;
+		case 'p':
+			cfg.processes = atoi(optarg);
+			break;
+		case 'd':
+			cfg.seconds = atoi(optarg);
+			break;
+		case 'n':
+			cfg.apps = atoi(optarg);
+			break;
+		case 'i':
+			cfg.interval_ms = atoi(optarg);
+			break;
+		case 's':
+			cfg.seed = strtoul(optarg, NULL, 10);
+			break;
+		case 'c':
+			cfg.caches = true;
+			break;
+		default:
+			_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (cfg.readers < 0 || cfg.writers < 0 || cfg.readers + cfg.writers <= 0
+			|| cfg.processes <= 0 || cfg.seconds <= 0 || cfg.apps <= 0 || cfg.interval_ms < 0) {
+		_usage(argv[0]);
+		return 1;
+	}
+
+	/* Count the lock waits of the children, see ail_stats_get_busy() */
+	setenv("AIL_DB_BUSY_STATS", "1", 1);
+
+	fds = calloc(cfg.processes, sizeof(*fds));
+	pids = calloc(cfg.processes, sizeof(pid_t));
+	if (!fds || !pids)
+		return 1;
+
+	if (corpus_write(CORPUS_DIRECTORY, STRESS_PREFIX, cfg.apps, cfg.seed) < 0)
+		return 1;
+
+	if (_in_child(_setup) < 0) {
+		corpus_remove(CORPUS_DIRECTORY, STRESS_PREFIX, cfg.apps);
+		return 1;
+	}
+
+	start = _now_us();
+	cfg.deadline = start + cfg.seconds * 1000000ULL;
+
+	for (i = 0; i < cfg.processes; i++) {
+		if (pipe(fds[i]) < 0 || (pids[i] = fork()) < 0) {
+			failed = 1;
+			cfg.processes = i;
+			break;
+		}
+		if (!pids[i]) {
+			close(fds[i][0]);
+			_run_process(i, &one);
+			_exit(write(fds[i][1], &one, sizeof(one)) == sizeof(one) ? 0 : 1);
+		}
+		close(fds[i][1]);
+	}
+
+	for (i = 0; i < cfg.processes; i++) {
+		if (read(fds[i][0], &one, sizeof(one)) == sizeof(one))
+			_merge(&total, &one);
+		else
+			failed = 1;
+		close(fds[i][0]);
+		waitpid(pids[i], NULL, 0);
+	}
+
+	if (!failed)
+		_report(&total, (_now_us() - start) / 1e6);
+
+	_in_child(_cleanup);
+	corpus_remove(CORPUS_DIRECTORY, STRESS_PREFIX, cfg.apps);
+
+	free(fds);
+	free(pids);
+
+	return failed;
+}
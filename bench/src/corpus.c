@@ -0,0 +1,151 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/*
+ * Synthetic .desktop files shaped like the ones of a device:
+ * localized names, one to three categories, a few MIME types and Tizen keys.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "corpus.h"
+
+static const char *locales[] = {
+	"en_US", "en_GB", "ko_KR", "fr_FR", "de_DE", "es_ES", "it_IT", "ja_JP", "zh_CN", "pt_BR", "ru_RU", "pl_PL",
+};
+
+static const char *categories[] = {
+	"AudioVideo", "Audio", "Video", "Development", "Education", "Game", "Graphics", "Network",
+	"Office", "Science", "Settings", "System", "Utility", "Bench",
+};
+
+static const char *mimetypes[] = {
+	"text/plain", "text/html", "text/x-vcard", "image/png", "image/jpeg", "image/gif", "audio/mpeg",
+	"audio/x-wav", "video/mp4", "video/3gpp", "application/pdf", "application/zip", "application/x-smil",
+};
+
+static const char *words[] = {
+	"Music", "Player", "Photo", "Viewer", "Mail", "Calendar", "Memo", "Voice", "Recorder", "Clock",
+	"Weather", "Maps", "Notes", "Camera", "Gallery", "Contacts", "Browser", "Radio", "Tasks", "Files",
+};
+
+#define N(array) ((int)(sizeof(array) / sizeof((array)[0])))
+
+void corpus_package(char *buf, int size, const char *prefix, int n)
+{
+	snprintf(buf, size, "%s.%d", prefix, n);
+}
+
+
+
+static int _write_one(const char *dir, const char *package, int n, unsigned int *seed)
+{
+	char path[512];
+	const char *word;
+	FILE *fp;
+	int count;
+	int first;
+	int i;
+
+	snprintf(path, sizeof(path), "%s/%s.desktop", dir, package);
+	fp = fopen(path, "w");
+	if (!fp)
+		return -1;
+
+	word = words[rand_r(seed) % N(words)];
+
+	fprintf(fp, "[Desktop Entry]\n");
+	fprintf(fp, "Name=%s %d\n", word, n);
+	count = rand_r(seed) % N(locales);
+	first = rand_r(seed) % N(locales);
+	for (i = 0; i < count; i++)
+		fprintf(fp, "Name[%s]=%s %d (%s)\n", locales[(first + i) % N(locales)], word, n,
+				locales[(first + i) % N(locales)]);
+	fprintf(fp, "Type=Application\n");
+	fprintf(fp, "Exec=/usr/apps/%s/bin/%s\n", package, package);
+	fprintf(fp, "Icon=%s.png\n", package);
+	fprintf(fp, "Version=%d.%d.%d\n", rand_r(seed) % 3, rand_r(seed) % 10, rand_r(seed) % 100);
+
+	fprintf(fp, "Categories=");
+	count = 1 + rand_r(seed) % 3;
+	first = rand_r(seed) % N(categories);
+	for (i = 0; i < count; i++)
+		fprintf(fp, "%s;", categories[(first + i) % N(categories)]);
+	fprintf(fp, "\n");
+
+	count = rand_r(seed) % 5;
+	if (count) {
+		fprintf(fp, "MimeType=");
+		first = rand_r(seed) % N(mimetypes);
+		for (i = 0; i < count; i++)
+			fprintf(fp, "%s%s", i ? ";" : "", mimetypes[(first + i) % N(mimetypes)]);
+		fprintf(fp, "\n");
+	}
+
+	fprintf(fp, "X-Tizen-PackageType=rpm\n");
+	fprintf(fp, "X-Tizen-PackageID=%s\n", package);
+	fprintf(fp, "X-Tizen-TaskManage=%s\n", rand_r(seed) % 8 ? "True" : "False");
+	fprintf(fp, "X-Tizen-Removable=%s\n", rand_r(seed) % 4 ? "True" : "False");
+	fprintf(fp, "NoDisplay=%s\n", rand_r(seed) % 10 ? "False" : "True");
+
+	fclose(fp);
+
+	return 0;
+}
+
+
+
+/* Returns 0, or -1 if a file could not be written */
+int corpus_write(const char *dir, const char *prefix, int count, unsigned int seed)
+{
+	char package[256];
+	int i;
+
+	for (i = 0; i < count; i++) {
+		corpus_package(package, sizeof(package), prefix, i);
+		if (_write_one(dir, package, i, &seed) < 0) {
+			fprintf(stderr, "Cannot write %s/%s.desktop\n", dir, package);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+
+void corpus_remove(const char *dir, const char *prefix, int count)
+{
+	char package[256];
+	char path[512];
+	int i;
+
+	for (i = 0; i < count; i++) {
+		corpus_package(package, sizeof(package), prefix, i);
+		snprintf(path, sizeof(path), "%s/%s.desktop", dir, package);
+		unlink(path);
+	}
+}
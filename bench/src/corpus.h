@@ -0,0 +1,40 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#ifndef __AIL_BENCH_CORPUS_H__
+#define __AIL_BENCH_CORPUS_H__
+
+#ifndef AIL_ROOT
+#define AIL_ROOT ""
+#endif
+
+#define CORPUS_DIRECTORY AIL_ROOT"/opt/share/applications"
+
+void corpus_package(char *buf, int size, const char *prefix, int n);
+int corpus_write(const char *dir, const char *prefix, int count, unsigned int seed);
+void corpus_remove(const char *dir, const char *prefix, int count);
+
+#endif  /* __AIL_BENCH_CORPUS_H__ */
@@ -0,0 +1,38 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/* Host stand-in for db-util, opening plain SQLite connections */
+
+#ifndef __DB_UTIL_H__
+#define __DB_UTIL_H__
+
+#include <sqlite3.h>
+
+#define DB_UTIL_REGISTER_HOOK_METHOD	0x00000001
+
+int db_util_open(const char *path, sqlite3 **db, int flags);
+int db_util_open_with_options(const char *path, sqlite3 **db, int flags, const char *vfs);
+int db_util_close(sqlite3 *db);
+
+#endif  /* __DB_UTIL_H__ */
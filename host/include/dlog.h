@@ -0,0 +1,56 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/* Host stand-in for dlog, printing to stderr */
+
+#ifndef __DLOG_H__
+#define __DLOG_H__
+
+#include <stdio.h>
+#include <stdarg.h>
+
+typedef enum {
+	DLOG_UNKNOWN = 0,
+	DLOG_DEFAULT,
+	DLOG_VERBOSE,
+	DLOG_DEBUG,
+	DLOG_INFO,
+	DLOG_WARN,
+	DLOG_ERROR,
+	DLOG_FATAL,
+	DLOG_SILENT,
+} log_priority;
+
+#ifndef LOG_TAG
+#define LOG_TAG NULL
+#endif
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...);
+
+#define LOGD(fmt, arg...) dlog_print(DLOG_DEBUG, LOG_TAG, fmt, ##arg)
+#define LOGI(fmt, arg...) dlog_print(DLOG_INFO, LOG_TAG, fmt, ##arg)
+#define LOGW(fmt, arg...) dlog_print(DLOG_WARN, LOG_TAG, fmt, ##arg)
+#define LOGE(fmt, arg...) dlog_print(DLOG_ERROR, LOG_TAG, fmt, ##arg)
+
+#endif  /* __DLOG_H__ */
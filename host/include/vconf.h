@@ -0,0 +1,48 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+/* Host stand-in for vconf, keeping each key in a file */
+
+#ifndef __VCONF_H__
+#define __VCONF_H__
+
+#define VCONFKEY_LANGSET	"db/menu_widget/language"
+
+typedef struct _keynode_t keynode_t;
+
+typedef void (*vconf_callback_fn) (keynode_t *node, void *user_data);
+
+int vconf_set_int(const char *key, int value);
+int vconf_set_str(const char *key, const char *value);
+int vconf_get_int(const char *key, int *value);
+char *vconf_get_str(const char *key);
+
+int vconf_notify_key_changed(const char *key, vconf_callback_fn cb, void *user_data);
+int vconf_ignore_key_changed(const char *key, vconf_callback_fn cb);
+
+char *vconf_keynode_get_name(keynode_t *node);
+int vconf_keynode_get_int(keynode_t *node);
+char *vconf_keynode_get_str(keynode_t *node);
+
+#endif  /* __VCONF_H__ */
@@ -0,0 +1,57 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+/*
+ * The platform db-util also registers collations and ICU hooks, none of which ail uses.
+ */
+
+#include <stdlib.h>
+#include <db-util.h>
+
+/* Milliseconds to wait for a lock held by another connection */
+#define DB_UTIL_BUSY_TIMEOUT	5000
+
+int db_util_open(const char *path, sqlite3 **db, int flags)
+{
+	return db_util_open_with_options(path, db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+}
+
+
+
+int db_util_open_with_options(const char *path, sqlite3 **db, int flags, const char *vfs)
+{
+	int ret;
+
+	ret = sqlite3_open_v2(path, db, flags, vfs);
+	if (ret == SQLITE_OK)
+		sqlite3_busy_timeout(*db, DB_UTIL_BUSY_TIMEOUT);
+
+	return ret;
+}
+
+
+
+int db_util_close(sqlite3 *db)
+{
+	return sqlite3_close(db);
+}
@@ -0,0 +1,75 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+/*
+ * Prints the messages of at least the priority in DLOG_PRIORITY, one of V D I W E F,
+ * or I when it is not set, the way dlogutil filters them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <dlog.h>
+
+static const char letters[] = "??VDIWEFS";
+static log_priority threshold;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+static void _init(void)
+{
+	const char *env = getenv("DLOG_PRIORITY");
+	const char *p;
+
+	threshold = DLOG_INFO;
+	if (env && *env && (p = strchr(letters + 2, *env)))
+		threshold = p - letters;
+}
+
+
+
+int dlog_print(log_priority prio, const char *tag, const char *fmt, ...)
+{
+	char buf[1024];
+	va_list ap;
+	int len;
+
+	pthread_once(&once, _init);
+	if (prio < threshold || prio >= DLOG_SILENT)
+		return 0;
+
+	va_start(ap, fmt);
+	len = vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+	if (len < 0)
+		return len;
+
+	flockfile(stderr);
+	fprintf(stderr, "%c/%s: %s", letters[prio], tag ? tag : "", buf);
+	if (!*buf || buf[strlen(buf) - 1] != '\n')
+		fputc('\n', stderr);
+	funlockfile(stderr);
+
+	return len;
+}
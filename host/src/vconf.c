@@ -0,0 +1,387 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+/*
+ * Each key is a file of VCONF_DIRECTORY holding "i:<int>" or "s:<string>",
+ * and changes of any process are seen through inotify on the default main loop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <glib.h>
+#include <vconf.h>
+
+#ifndef AIL_ROOT
+#define AIL_ROOT ""
+#endif
+
+#define VCONF_DIRECTORY AIL_ROOT"/opt/var/kdb"
+
+struct _keynode_t {
+	char *name;
+	char *value;	/* as stored */
+};
+
+struct watch {
+	char *key;
+	vconf_callback_fn cb;
+	void *user_data;
+};
+
+/* Keys every device has */
+static const struct {
+	const char *key;
+	const char *value;
+} defaults[] = {
+	{ VCONFKEY_LANGSET, "s:en_US.UTF-8" },
+};
+
+static struct {
+	pthread_mutex_t lock;
+	GSList *watches;
+	int fd;
+	guint source;
+} notify = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.watches = NULL,
+	.fd = -1,
+	.source = 0,
+};
+
+static char *_path(const char *key, const char *prefix)
+{
+	char *path;
+	char *p;
+
+	path = g_strdup_printf(VCONF_DIRECTORY"/%s%s", prefix, key);
+	for (p = path + strlen(VCONF_DIRECTORY"/"); *p; p++) {
+		if (*p == '/')
+			*p = '+';
+	}
+
+	return path;
+}
+
+
+
+static char *_read(const char *key)
+{
+	char *path;
+	char *value = NULL;
+	int i;
+
+	path = _path(key, "");
+	if (!g_file_get_contents(path, &value, NULL, NULL)) {
+		value = NULL;
+		for (i = 0; i < sizeof(defaults) / sizeof(defaults[0]); i++) {
+			if (!strcmp(defaults[i].key, key)) {
+				value = g_strdup(defaults[i].value);
+				break;
+			}
+		}
+	}
+	g_free(path);
+
+	return value;
+}
+
+
+
+/* Written aside and renamed, so readers never see half a value */
+static int _write(const char *key, const char *value)
+{
+	char *path;
+	char *tmp;
+	char prefix[32];
+	int ret = 0;
+
+	g_mkdir_with_parents(VCONF_DIRECTORY, 0755);
+
+	snprintf(prefix, sizeof(prefix), ".%d.", getpid());
+	path = _path(key, "");
+	tmp = _path(key, prefix);
+
+	if (!g_file_set_contents(tmp, value, -1, NULL) || rename(tmp, path) < 0) {
+		unlink(tmp);
+		ret = -1;
+	}
+
+	g_free(tmp);
+	g_free(path);
+
+	return ret;
+}
+
+
+
+int vconf_set_int(const char *key, int value)
+{
+	char buf[32];
+
+	if (!key)
+		return -1;
+
+	snprintf(buf, sizeof(buf), "i:%d", value);
+
+	return _write(key, buf);
+}
+
+
+
+int vconf_set_str(const char *key, const char *value)
+{
+	char *buf;
+	int ret;
+
+	if (!key || !value)
+		return -1;
+
+	buf = g_strdup_printf("s:%s", value);
+	ret = _write(key, buf);
+	g_free(buf);
+
+	return ret;
+}
+
+
+
+int vconf_get_int(const char *key, int *value)
+{
+	char *stored;
+	int ret = -1;
+
+	if (!key || !value)
+		return -1;
+
+	stored = _read(key);
+	if (stored && !strncmp(stored, "i:", 2)) {
+		*value = atoi(stored + 2);
+		ret = 0;
+	}
+	g_free(stored);
+
+	return ret;
+}
+
+
+
+char *vconf_get_str(const char *key)
+{
+	char *stored;
+	char *value = NULL;
+
+	if (!key)
+		return NULL;
+
+	stored = _read(key);
+	if (stored && !strncmp(stored, "s:", 2))
+		value = strdup(stored + 2);
+	g_free(stored);
+
+	return value;
+}
+
+
+
+static void _dispatch(const char *name)
+{
+	struct _keynode_t node;
+	struct watch *w;
+	GArray *calls;
+	GSList *l;
+	char *p;
+	int i;
+
+	node.name = g_strdup(name);
+	for (p = node.name; *p; p++) {
+		if (*p == '+')
+			*p = '/';
+	}
+
+	/* Copied, the callbacks may ignore their key */
+	calls = g_array_new(FALSE, FALSE, sizeof(struct watch));
+	pthread_mutex_lock(&notify.lock);
+	for (l = notify.watches; l; l = g_slist_next(l)) {
+		w = l->data;
+		if (!strcmp(w->key, node.name))
+			g_array_append_val(calls, *w);
+	}
+	pthread_mutex_unlock(&notify.lock);
+
+	if (calls->len) {
+		node.value = _read(node.name);
+		for (i = 0; i < calls->len; i++) {
+			w = &g_array_index(calls, struct watch, i);
+			w->cb(&node, w->user_data);
+		}
+		g_free(node.value);
+	}
+
+	g_array_free(calls, TRUE);
+	g_free(node.name);
+}
+
+
+
+static gboolean _inotify_cb(GIOChannel *channel, GIOCondition condition, gpointer data)
+{
+	char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	const struct inotify_event *event;
+	ssize_t len;
+	char *p;
+
+	len = read(g_io_channel_unix_get_fd(channel), buf, sizeof(buf));
+	if (len <= 0)
+		return TRUE;
+
+	for (p = buf; p < buf + len; p += sizeof(struct inotify_event) + event->len) {
+		event = (const struct inotify_event *)p;
+		/* Values being written are hidden */
+		if (event->len && event->name[0] != '.')
+			_dispatch(event->name);
+	}
+
+	return TRUE;
+}
+
+
+
+/* Must be called with notify.lock held */
+static int _start_notify(void)
+{
+	GIOChannel *channel;
+
+	g_mkdir_with_parents(VCONF_DIRECTORY, 0755);
+
+	notify.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (notify.fd < 0)
+		return -1;
+
+	if (inotify_add_watch(notify.fd, VCONF_DIRECTORY, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		close(notify.fd);
+		notify.fd = -1;
+		return -1;
+	}
+
+	channel = g_io_channel_unix_new(notify.fd);
+	notify.source = g_io_add_watch(channel, G_IO_IN, _inotify_cb, NULL);
+	g_io_channel_unref(channel);
+
+	return 0;
+}
+
+
+
+int vconf_notify_key_changed(const char *key, vconf_callback_fn cb, void *user_data)
+{
+	struct watch *w;
+
+	if (!key || !cb)
+		return -1;
+
+	w = calloc(1, sizeof(struct watch));
+	if (!w)
+		return -1;
+	w->key = strdup(key);
+	w->cb = cb;
+	w->user_data = user_data;
+
+	pthread_mutex_lock(&notify.lock);
+	if (!w->key || (notify.fd < 0 && _start_notify() < 0)) {
+		pthread_mutex_unlock(&notify.lock);
+		free(w->key);
+		free(w);
+		return -1;
+	}
+	notify.watches = g_slist_append(notify.watches, w);
+	pthread_mutex_unlock(&notify.lock);
+
+	return 0;
+}
+
+
+
+int vconf_ignore_key_changed(const char *key, vconf_callback_fn cb)
+{
+	struct watch *w;
+	GSList *l;
+
+	if (!key || !cb)
+		return -1;
+
+	pthread_mutex_lock(&notify.lock);
+	for (l = notify.watches; l; l = g_slist_next(l)) {
+		w = l->data;
+		if (w->cb == cb && !strcmp(w->key, key))
+			break;
+	}
+	if (!l) {
+		pthread_mutex_unlock(&notify.lock);
+		return -1;
+	}
+
+	notify.watches = g_slist_delete_link(notify.watches, l);
+	free(w->key);
+	free(w);
+
+	if (!notify.watches) {
+		g_source_remove(notify.source);
+		close(notify.fd);
+		notify.fd = -1;
+	}
+	pthread_mutex_unlock(&notify.lock);
+
+	return 0;
+}
+
+
+
+char *vconf_keynode_get_name(keynode_t *node)
+{
+	return node ? node->name : NULL;
+}
+
+
+
+int vconf_keynode_get_int(keynode_t *node)
+{
+	if (!node || !node->value || strncmp(node->value, "i:", 2))
+		return 0;
+
+	return atoi(node->value + 2);
+}
+
+
+
+/* Owned by the node, like with vconf */
+char *vconf_keynode_get_str(keynode_t *node)
+{
+	if (!node || !node->value || strncmp(node->value, "s:", 2))
+		return NULL;
+
+	return node->value + 2;
+}
@@ -0,0 +1,131 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+/*
+ * Only the two lookups ail makes, over the aliases and subclasses files of the host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include <xdgmime.h>
+
+#define MIME_DIRECTORY "/usr/share/mime"
+
+static GHashTable *aliases;	/* alias to type */
+static GHashTable *parents;	/* type to a GPtrArray of its parents */
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+static void _read_pairs(const char *path, void (*add)(char *first, char *second))
+{
+	FILE *fp;
+	char line[512];
+	char first[256];
+	char second[256];
+
+	fp = fopen(path, "r");
+	if (!fp)
+		return;
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (sscanf(line, "%255s %255s", first, second) == 2)
+			add(g_strdup(first), g_strdup(second));
+	}
+
+	fclose(fp);
+}
+
+
+
+static void _add_alias(char *alias, char *type)
+{
+	g_hash_table_replace(aliases, alias, type);
+}
+
+
+
+static void _add_parent(char *type, char *parent)
+{
+	GPtrArray *list;
+
+	list = g_hash_table_lookup(parents, type);
+	if (!list) {
+		list = g_ptr_array_new_with_free_func(g_free);
+		g_hash_table_insert(parents, type, list);
+	} else {
+		g_free(type);
+	}
+
+	g_ptr_array_add(list, parent);
+}
+
+
+
+static void _init(void)
+{
+	aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	parents = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+
+	_read_pairs(MIME_DIRECTORY"/aliases", _add_alias);
+	_read_pairs(MIME_DIRECTORY"/subclasses", _add_parent);
+}
+
+
+
+const char *xdg_mime_unalias_mime_type(const char *mime)
+{
+	const char *type;
+
+	pthread_once(&once, _init);
+
+	type = g_hash_table_lookup(aliases, mime);
+
+	return type ? type : mime;
+}
+
+
+
+/* The array is to be freed by the caller, not its strings */
+char **xdg_mime_list_mime_parents(const char *mime)
+{
+	GPtrArray *list;
+	char **result;
+	int i;
+
+	pthread_once(&once, _init);
+
+	list = g_hash_table_lookup(parents, xdg_mime_unalias_mime_type(mime));
+	if (!list)
+		return NULL;
+
+	result = calloc(list->len + 1, sizeof(char *));
+	if (!result)
+		return NULL;
+
+	for (i = 0; i < list->len; i++)
+		result[i] = g_ptr_array_index(list, i);
+
+	return result;
+}
@@ -26,6 +26,7 @@
 #define __AIL_H__
 
 #include <stdbool.h>
+#include <glib.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -88,6 +89,35 @@ extern "C" {
 #define	AIL_PROP_X_SLP_INACTIVATED_BOOL		"AIL_PROP_X_SLP_INACTIVATED_BOOL"
 
 
+/**
+ * @brief stable property IDs. They can be used instead of the property strings with the _by_id functions.
+ */
+typedef enum {
+	AIL_PROP_ID_PACKAGE_STR			= 0,
+	AIL_PROP_ID_EXEC_STR			= 1,
+	AIL_PROP_ID_NAME_STR			= 2,
+	AIL_PROP_ID_TYPE_STR			= 3,
+	AIL_PROP_ID_ICON_STR			= 4,
+	AIL_PROP_ID_CATEGORIES_STR		= 5,
+	AIL_PROP_ID_VERSION_STR			= 6,
+	AIL_PROP_ID_MIMETYPE_STR		= 7,
+	AIL_PROP_ID_X_SLP_SERVICE_STR		= 8,
+	AIL_PROP_ID_X_SLP_PACKAGETYPE_STR	= 9,
+	AIL_PROP_ID_X_SLP_PACKAGECATEGORIES_STR	= 10,
+	AIL_PROP_ID_X_SLP_PACKAGEID_STR		= 11,
+	AIL_PROP_ID_X_SLP_SVC_STR		= 13,
+	AIL_PROP_ID_X_SLP_EXE_PATH		= 14,
+	AIL_PROP_ID_X_SLP_APPID_STR		= 15,
+	AIL_PROP_ID_X_SLP_TEMP_INT		= 16,
+	AIL_PROP_ID_X_SLP_INSTALLEDTIME_INT	= 17,
+	AIL_PROP_ID_NODISPLAY_BOOL		= 18,
+	AIL_PROP_ID_X_SLP_TASKMANAGE_BOOL	= 19,
+	AIL_PROP_ID_X_SLP_MULTIPLE_BOOL		= 20,
+	AIL_PROP_ID_X_SLP_REMOVABLE_BOOL	= 21,
+	AIL_PROP_ID_X_SLP_INACTIVATED_BOOL	= 23,
+} ail_prop_id_e;
+
+
 /**
  * @brief A handle for filters
  */
@@ -108,6 +138,7 @@ typedef enum {
 	AIL_ERROR_OUT_OF_MEMORY = -3,			/**< Out of memory */
 	AIL_ERROR_INVALID_PARAMETER = -4,		/**< Invalid parameter */
 	AIL_ERROR_NO_DATA = -5,					/**< Success, but no data */
+	AIL_ERROR_EXPIRED = -6,					/**< Requested history is no longer kept */
 } ail_error_e;
 
 /**
@@ -283,6 +314,8 @@ ail_error_e ail_filter_add_bool(ail_filter_h filter, const char *property, bool
  * @fn ail_error_e ail_error_e ail_filter_add_str(ail_filter_h filter, const char *property, const char *value)
  *
  * @brief Add string condition to filter by. The string is case-sensitive.
+ *	For the list properties AIL_PROP_CATEGORIES_STR, AIL_PROP_MIMETYPE_STR, AIL_PROP_X_SLP_SERVICE_STR,
+ *	AIL_PROP_X_SLP_PACKAGECATEGORIES_STR and AIL_PROP_X_SLP_SVC_STR, the value must be one whole entry of the ';'-separated list, in any case.
  *
  * @par Sync (or) Async : Synchronous API
  *
@@ -334,6 +367,75 @@ ail_error_e ail_filter_add_str(ail_filter_h filter, const char *property, const
 
 
 
+/**
+ * @fn ail_error_e ail_filter_add_search(ail_filter_h filter, const char *query)
+ *
+ * @brief Add a name search to filter by. Every word of the query must start a word of the name shown to the user, case-insensitively.
+ *	Results of ail_filter_list_appinfo_foreach() are ranked: an exact name first, then names starting with the query, then the other matches.
+ *	A filter has one search, adding another one replaces it.
+ *	If SQLite was built without FTS4, names are matched with LIKE instead of the name index, which is slower.
+ *
+ * @par Sync (or) Async : Synchronous API
+ *
+ * @param[in] filter	 a filter handle which can be create with ail_filter_new()
+ * @param[in] query	 words typed by the user. Punctuation separates words and is otherwise ignored.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter, or no word in query
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre The filter should be valid handle which was created by ail_filter_new()
+ *
+ * @see  ail_filter_new(), ail_filter_list_appinfo_foreach()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+ail_cb_ret_e appinfo_func(const ail_appinfo_h appinfo, void *user_data)
+{
+	char *name;
+
+	ail_appinfo_get_str(appinfo, AIL_PROP_NAME_STR, &name);
+	fprintf(stderr, "%s\n", name);
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+int search_apps(const char *typed)
+{
+	ail_filter_h filter;
+	ail_error_e ret;
+
+	ret = ail_filter_new(&filter);
+	if (ret != AIL_ERROR_OK) {
+		return -1;
+	}
+
+	ret = ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+	if (ret != AIL_ERROR_OK) {
+		ail_filter_destroy(filter);
+		return -1;
+	}
+
+	ret = ail_filter_add_search(filter, typed);
+	if (ret != AIL_ERROR_OK) {
+		ail_filter_destroy(filter);
+		return -1;
+	}
+
+	ail_filter_list_appinfo_foreach(filter, appinfo_func, NULL);
+	ail_filter_destroy(filter);
+
+	return 0;
+}
+ * @endcode
+ */
+ail_error_e ail_filter_add_search(ail_filter_h filter, const char *query);
+
+
+
 /**
  * @fn ail_error_e ail_filter_destroy(ail_filter_h filter)
  *
@@ -500,6 +602,55 @@ ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter,
 
 
 
+/**
+ * @fn ail_error_e ail_mime_get_handlers(const char *mime, ail_list_appinfo_cb cb, void *user_data)
+ *
+ * @brief find the applications that can open a MIME type.
+ *	An application handles the type if it declares the type itself, one of its ancestors (subclass-of relations of the shared MIME database),
+ *	text/plain for text types, the wildcard of its media type such as image/\*, or application/octet-stream.
+ *	Aliases are resolved first. Applications are called back once each, the most specific declaration first.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] mime		a MIME type such as "image/png"
+ * @param[in] cb		the function called for each handler
+ * @param[in] user_data	user data passed to cb
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_filter_add_str()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+ail_cb_ret_e handler_func(const ail_appinfo_h appinfo, void *user_data)
+{
+	char *package;
+
+	ail_appinfo_get_str(appinfo, AIL_PROP_PACKAGE_STR, &package);
+	fprintf(stderr, "%s can open it\n", package);
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+int list_handlers(void)
+{
+	return ail_mime_get_handlers("text/x-csrc", handler_func, NULL);
+}
+ * @endcode
+ */
+ail_error_e ail_mime_get_handlers(const char *mime, ail_list_appinfo_cb cb, void *user_data);
+
+
+
 /**
  * @fn ail_error_e ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *count)
  *
@@ -681,6 +832,87 @@ static ail_error_e _get_name(const char *appid)
 ail_error_e ail_get_appinfo(const char *appid, ail_appinfo_h *handle);
 
 
+
+/**
+ * @fn ail_error_e ail_get_appinfo_by_exe_path(const char *path, ail_appinfo_h *handle)
+ *
+ * @brief get the application whose executable is path, for example the target of /proc/<pid>/exe.
+	The executable is the first word of the Exec entry. It is indexed as declared and with symlinks resolved at registration,
+	and path is resolved too if it is not found as given.
+
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] path absolute path of an executable.
+ * @param[out] handle handle will be used with the functions of ail_appinfo_get_xxx. If no data, it will be NULL.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ * @retval	AIL_ERROR_NO_DATA				no data. no application has this executable.
+ *
+ * @pre None
+ * @post destroy the handle with the function of ail_destroy_appinfo after using it all.
+ *
+ * @see  ail_get_appinfo_by_exe_paths(), ail_get_appinfo()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_get_appinfo_by_exe_path(const char *path, ail_appinfo_h *handle);
+
+
+
+/**
+ * @fn ail_error_e ail_get_appinfo_by_exe_paths(const char **paths, int count, ail_appinfo_h *handles)
+ *
+ * @brief get the applications of several executables at once, as ail_get_appinfo_by_exe_path() does for one.
+	The paths are looked up with a few queries rather than one per path.
+
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] paths array of count executable paths. NULL entries are skipped.
+ * @param[in] count number of paths.
+ * @param[out] handles array of count handles. handles[i] is the application of paths[i], or NULL if there is none.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success, even if no path is found
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post destroy every handle which is not NULL with the function of ail_destroy_appinfo. On failure all handles are NULL.
+ *
+ * @see  ail_get_appinfo_by_exe_path()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _print_apps(const char **exes, int n)
+{
+	ail_appinfo_h handles[n];
+	char *package;
+	int i;
+
+	if (ail_get_appinfo_by_exe_paths(exes, n, handles) != AIL_ERROR_OK)
+		return;
+
+	for (i = 0; i < n; i++) {
+		if (!handles[i])
+			continue;
+		ail_appinfo_get_str(handles[i], AIL_PROP_PACKAGE_STR, &package);
+		fprintf(stderr, "%s : %s\n", exes[i], package);
+		ail_destroy_appinfo(handles[i]);
+	}
+}
+ * @endcode
+ */
+ail_error_e ail_get_appinfo_by_exe_paths(const char **paths, int count, ail_appinfo_h *handles);
+
+
 /**
  * @fn ail_error_e ail_appinfo_get_bool(const ail_appinfo_h handle, const char *property, bool *value)
  *
@@ -806,7 +1038,7 @@ ail_error_e ail_appinfo_get_int(const ail_appinfo_h handle, const char *property
  *
  * @param[in] handle	the handle is defined by calling ail_get_appinfo.
  * @param[in] property	a property type of string.
- * @param[out] str		a out-parameter string that is mapped with the property. The icon property contains the absolute file path. If there is no data, the value of str is NULL.
+ * @param[out] str		a out-parameter string that is mapped with the property. The icon property contains the absolute file path for the current theme, see ail_appinfo_get_icon_path(). If there is no data, the value of str is NULL.
  *
  * @return 0 if success, negative value(<0) if fail\n
  * @retval	AIL_ERROR_OK					success
@@ -853,162 +1085,346 @@ ail_error_e ail_appinfo_get_str(const ail_appinfo_h handle, const char *property
 
 
 /**
- * @fn ail_error_e ail_package_destroy_appinfo(const ail_appinfo_h handle)
+ * @fn ail_error_e ail_filter_add_bool_by_id(ail_filter_h filter, ail_prop_id_e id, bool value)
  *
- * @brief destroy a handle what you get with the function of ail_package_get_appinfo.
+ * @brief add a boolean condition to the filter, like ail_filter_add_bool() but with a property ID, so no string is compared.
  *
  * @par Sync (or) Async : Synchronous API.
  *
- * @param[in] handle destroy all resources related to the handle.
+ * @param[in] filter	the filter to which the condition is added
+ * @param[in] id		a boolean property ID
+ * @param[in] value	the value of the property
  *
  * @return 0 if success, negative value(<0) if fail\n
  * @retval	AIL_ERROR_OK					success
- * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
  * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
  *
- * @pre need a handle that you don't need anymore.
- * @post cannot use the handle after destroying.
+ * @pre filter has been created by ail_filter_new()
+ * @post None
  *
- * @see  ail_package_get_appinfo(), ail_appinfo_get_bool(), ail_appinfo_get_int(), ail_appinfo_get_str()
+ * @see  ail_filter_add_bool(), ail_filter_add_int_by_id(), ail_filter_add_str_by_id()
  *
  * @par Prospective Clients:
  * External Apps.
- *
- * @code
-static ail_error_e _get_name(const char *package)
-{
-	ail_appinfo_h handle;
-	ail_error_e ret;
-	char *str;
-
-	ret = ail_package_get_appinfo(package, &handle);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-
-	ret = ail_appinfo_get_str(handle, AIL_PROP_NAME_STR, &str);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-	fprintf(stderr, "Package[%s], Property[%s] : %s\n", package, property, str);
-
-	ret = ail_package_destroy_appinfo(handle);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-
-	return AIL_ERROR_OK;
-}
- * @endcode
  */
-ail_error_e ail_package_destroy_appinfo(const ail_appinfo_h handle);
+ail_error_e ail_filter_add_bool_by_id(ail_filter_h filter, ail_prop_id_e id, bool value);
+
 
 
 /**
- * @fn ail_error_e ail_destroy_appinfo(const ail_appinfo_h handle)
+ * @fn ail_error_e ail_filter_add_int_by_id(ail_filter_h filter, ail_prop_id_e id, int value)
  *
- * @brief destroy a handle what you get with the function of ail_get_appinfo.
+ * @brief add an integer condition to the filter, like ail_filter_add_int() but with a property ID, so no string is compared.
  *
  * @par Sync (or) Async : Synchronous API.
  *
- * @param[in] handle destroy all resources related to the handle.
+ * @param[in] filter	the filter to which the condition is added
+ * @param[in] id		an integer property ID
+ * @param[in] value	the value of the property
  *
  * @return 0 if success, negative value(<0) if fail\n
  * @retval	AIL_ERROR_OK					success
- * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
  * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
  *
- * @pre need a handle that you don't need anymore.
- * @post cannot use the handle after destroying.
+ * @pre filter has been created by ail_filter_new()
+ * @post None
  *
- * @see  ail_get_appinfo(), ail_appinfo_get_bool(), ail_appinfo_get_int(), ail_appinfo_get_str()
+ * @see  ail_filter_add_int(), ail_filter_add_bool_by_id(), ail_filter_add_str_by_id()
  *
  * @par Prospective Clients:
  * External Apps.
- *
- * @code
-static ail_error_e _get_name(const char *appid)
-{
-	ail_appinfo_h handle;
-	ail_error_e ret;
-	char *str;
-
-	ret = ail_get_appinfo(appid, &handle);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-
-	ret = ail_appinfo_get_str(handle, AIL_PROP_NAME_STR, &str);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-	fprintf(stderr, "Package[%s], Property[%s] : %s\n", appid, property, str);
-
-	ret = ail_destroy_appinfo(handle);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-
-	return AIL_ERROR_OK;
-}
- * @endcode
  */
-ail_error_e ail_destroy_appinfo(const ail_appinfo_h handle);
+ail_error_e ail_filter_add_int_by_id(ail_filter_h filter, ail_prop_id_e id, int value);
+
 
 
 /**
- * @fn ail_error_e ail_desktop_add(const char *package)
+ * @fn ail_error_e ail_filter_add_str_by_id(ail_filter_h filter, ail_prop_id_e id, const char *value)
  *
- * @brief add a package information into Application Information Database.
-	A desktop file for this package has to be installed in the desktop directory before using this API.
-	If there is no database for Application Information Database, this API will create the DB.
-	If there is a DB, this function adds information for the package into the DB.
-	And a notification is published to the applications who want to know about changing DB. 
+ * @brief add a string condition to the filter, like ail_filter_add_str() but with a property ID, so no string is compared to find the property.
  *
  * @par Sync (or) Async : Synchronous API.
  *
- * @param[in] package package name
+ * @param[in] filter	the filter to which the condition is added
+ * @param[in] id		a string property ID
+ * @param[in] value	the value of the property
  *
  * @return 0 if success, negative value(<0) if fail\n
  * @retval	AIL_ERROR_OK					success
- * @retval	AIL_ERROR_FAIL					internal error
- * @retval 	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
  *
- * @pre a desktop file for the package has to be installed in the desktop directory before using this API.
- * @post package information is added into the Application Information Database.
+ * @pre filter has been created by ail_filter_new()
+ * @post None
  *
- * @see  ail_desktop_update(), ail_desktop_remove()
+ * @see  ail_filter_add_str(), ail_filter_add_bool_by_id(), ail_filter_add_int_by_id()
  *
  * @par Prospective Clients:
  * External Apps.
- *
- * @code
-static ail_error_e _add_desktop(const char *package)
-{
-	ail_error_e ret;
-
-	if (!package) {
-		return AIL_ERROR_FAIL;
-	}
-
-	ret = ail_desktop_add(package);
-	if (ret != AIL_ERROR_OK) {
-		return AIL_ERROR_FAIL;
-	}
-
-	return AIL_ERROR_OK;
-}
- * @endcode
  */
-ail_error_e ail_desktop_add(const char *package);
+ail_error_e ail_filter_add_str_by_id(ail_filter_h filter, ail_prop_id_e id, const char *value);
 
 
 
 /**
- * @fn ail_error_e ail_desktop_update(const char *package)
+ * @fn ail_error_e ail_appinfo_get_bool_by_id(const ail_appinfo_h handle, ail_prop_id_e id, bool *value)
  *
- * @brief update a package information in the Application Information Database.
+ * @brief get a boolean value like ail_appinfo_get_bool(), but with a property ID. Use it in loops over many handles.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle	the handle is defined by calling ail_get_appinfo.
+ * @param[in] id		a boolean property ID
+ * @param[out] value	a out-parameter value that is mapped with the property.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre define a handle using ail_get_appinfo. The handle is used as a first argument of this API.
+ * @post destroy the handle with the function of ail_destroy_appinfo after using it all.
+ *
+ * @see  ail_appinfo_get_bool(), ail_appinfo_get_int_by_id(), ail_appinfo_get_str_by_id()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_appinfo_get_bool_by_id(const ail_appinfo_h handle, ail_prop_id_e id, bool *value);
+
+
+
+/**
+ * @fn ail_error_e ail_appinfo_get_int_by_id(const ail_appinfo_h handle, ail_prop_id_e id, int *value)
+ *
+ * @brief get an integer value like ail_appinfo_get_int(), but with a property ID. Use it in loops over many handles.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle	the handle is defined by calling ail_get_appinfo.
+ * @param[in] id		an integer property ID
+ * @param[out] value	a out-parameter value that is mapped with the property.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre define a handle using ail_get_appinfo. The handle is used as a first argument of this API.
+ * @post destroy the handle with the function of ail_destroy_appinfo after using it all.
+ *
+ * @see  ail_appinfo_get_int(), ail_appinfo_get_bool_by_id(), ail_appinfo_get_str_by_id()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_appinfo_get_int_by_id(const ail_appinfo_h handle, ail_prop_id_e id, int *value);
+
+
+
+/**
+ * @fn ail_error_e ail_appinfo_get_str_by_id(const ail_appinfo_h handle, ail_prop_id_e id, char **str)
+ *
+ * @brief get a string like ail_appinfo_get_str(), but with a property ID. Use it in loops over many handles.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle	the handle is defined by calling ail_get_appinfo.
+ * @param[in] id		a string property ID
+ * @param[out] str		a out-parameter string that is mapped with the property. If there is no data, the value of str is NULL.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre define a handle using ail_get_appinfo. The handle is used as a first argument of this API.
+ * @post str doesn't need to be freed. It will be freed by calling ail_destroy_appinfo.
+ *
+ * @see  ail_appinfo_get_str(), ail_appinfo_get_bool_by_id(), ail_appinfo_get_int_by_id()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+ail_cb_ret_e appinfo_func(const ail_appinfo_h appinfo, void *user_data)
+{
+	char *package;
+	bool nodisplay;
+
+	ail_appinfo_get_str_by_id(appinfo, AIL_PROP_ID_PACKAGE_STR, &package);
+	ail_appinfo_get_bool_by_id(appinfo, AIL_PROP_ID_NODISPLAY_BOOL, &nodisplay);
+	printf("%s %d\n", package, nodisplay);
+
+	return AIL_CB_RET_CONTINUE;
+}
+ * @endcode
+ */
+ail_error_e ail_appinfo_get_str_by_id(const ail_appinfo_h handle, ail_prop_id_e id, char **str);
+
+
+
+/**
+ * @fn ail_error_e ail_appinfo_get_icon_path(const ail_appinfo_h handle, const char *theme, const char *size, char **path)
+ *
+ * @brief get the path of the icon of an application for an icon theme and size.
+	The App Info DB keeps the icon name of the desktop file, its path is looked up in the icon directories of the theme,
+	then of the default theme. Paths are cached until the theme or the installed applications change.
+	The icon property of ail_appinfo_get_str() is this path for the current theme and the small icons.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle	the handle is defined by calling ail_get_appinfo.
+ * @param[in] theme		an icon theme, NULL for the current one
+ * @param[in] size		an icon size directory, NULL for "small"
+ * @param[out] path		the absolute file path of the icon. If the application has no icon, the value of path is NULL.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre define a handle using ail_get_appinfo. The handle is used as a first argument of this API.
+ * @post path doesn't need to be freed. It will be freed by calling ail_destroy_appinfo.
+ *	For the handle given to a callback of ail_filter_list_appinfo_foreach(), ail_mime_get_handlers() or ail_filter_watch(),
+ *	it is valid until the callback returns.
+ *
+ * @see  ail_appinfo_get_str(), ail_get_appinfo()
+ *
+ * @par Prospective Clients:
+ * Menu screen, theme settings.
+ *
+ * @code
+ail_cb_ret_e appinfo_func(const ail_appinfo_h appinfo, void *user_data)
+{
+	const char *theme = user_data;
+	char *path;
+
+	if (ail_appinfo_get_icon_path(appinfo, theme, NULL, &path) == AIL_ERROR_OK && path)
+		printf("%s\n", path);
+
+	return AIL_CB_RET_CONTINUE;
+}
+ * @endcode
+ */
+ail_error_e ail_appinfo_get_icon_path(const ail_appinfo_h handle, const char *theme, const char *size, char **path);
+
+
+
+/**
+ * @fn ail_error_e ail_package_destroy_appinfo(const ail_appinfo_h handle)
+ *
+ * @brief destroy a handle what you get with the function of ail_package_get_appinfo.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle destroy all resources related to the handle.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre need a handle that you don't need anymore.
+ * @post cannot use the handle after destroying.
+ *
+ * @see  ail_package_get_appinfo(), ail_appinfo_get_bool(), ail_appinfo_get_int(), ail_appinfo_get_str()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static ail_error_e _get_name(const char *package)
+{
+	ail_appinfo_h handle;
+	ail_error_e ret;
+	char *str;
+
+	ret = ail_package_get_appinfo(package, &handle);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+
+	ret = ail_appinfo_get_str(handle, AIL_PROP_NAME_STR, &str);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+	fprintf(stderr, "Package[%s], Property[%s] : %s\n", package, property, str);
+
+	ret = ail_package_destroy_appinfo(handle);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+
+	return AIL_ERROR_OK;
+}
+ * @endcode
+ */
+ail_error_e ail_package_destroy_appinfo(const ail_appinfo_h handle);
+
+
+/**
+ * @fn ail_error_e ail_destroy_appinfo(const ail_appinfo_h handle)
+ *
+ * @brief destroy a handle what you get with the function of ail_get_appinfo.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] handle destroy all resources related to the handle.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre need a handle that you don't need anymore.
+ * @post cannot use the handle after destroying.
+ *
+ * @see  ail_get_appinfo(), ail_appinfo_get_bool(), ail_appinfo_get_int(), ail_appinfo_get_str()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static ail_error_e _get_name(const char *appid)
+{
+	ail_appinfo_h handle;
+	ail_error_e ret;
+	char *str;
+
+	ret = ail_get_appinfo(appid, &handle);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+
+	ret = ail_appinfo_get_str(handle, AIL_PROP_NAME_STR, &str);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+	fprintf(stderr, "Package[%s], Property[%s] : %s\n", appid, property, str);
+
+	ret = ail_destroy_appinfo(handle);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+
+	return AIL_ERROR_OK;
+}
+ * @endcode
+ */
+ail_error_e ail_destroy_appinfo(const ail_appinfo_h handle);
+
+
+/**
+ * @fn ail_error_e ail_desktop_add(const char *package)
+ *
+ * @brief add a package information into Application Information Database.
 	A desktop file for this package has to be installed in the desktop directory before using this API.
+	If there is no database for Application Information Database, this API will create the DB.
+	If there is a DB, this function adds information for the package into the DB.
 	And a notification is published to the applications who want to know about changing DB. 
  *
  * @par Sync (or) Async : Synchronous API.
@@ -1021,15 +1437,15 @@ ail_error_e ail_desktop_add(const char *package);
  * @retval 	AIL_ERROR_INVALID_PARAMETER		invalid parameter
  *
  * @pre a desktop file for the package has to be installed in the desktop directory before using this API.
- * @post update a package information in the Application Information Database.
+ * @post package information is added into the Application Information Database.
  *
- * @see  ail_desktop_add(), ail_desktop_remove()
+ * @see  ail_desktop_update(), ail_desktop_remove()
  *
  * @par Prospective Clients:
  * External Apps.
  *
  * @code
-static ail_error_e _update_desktop(const char *package)
+static ail_error_e _add_desktop(const char *package)
 {
 	ail_error_e ret;
 
@@ -1037,7 +1453,7 @@ static ail_error_e _update_desktop(const char *package)
 		return AIL_ERROR_FAIL;
 	}
 
-	ret = ail_desktop_update(package);
+	ret = ail_desktop_add(package);
 	if (ret != AIL_ERROR_OK) {
 		return AIL_ERROR_FAIL;
 	}
@@ -1046,14 +1462,15 @@ static ail_error_e _update_desktop(const char *package)
 }
  * @endcode
  */
-ail_error_e ail_desktop_update(const char *package);
+ail_error_e ail_desktop_add(const char *package);
 
 
 
 /**
- * @fn ail_error_e ail_desktop_remove(const char *package)
+ * @fn ail_error_e ail_desktop_update(const char *package)
  *
- * @brief remove a package information in the Application Information Database.
+ * @brief update a package information in the Application Information Database.
+	A desktop file for this package has to be installed in the desktop directory before using this API.
 	And a notification is published to the applications who want to know about changing DB. 
  *
  * @par Sync (or) Async : Synchronous API.
@@ -1065,16 +1482,16 @@ ail_error_e ail_desktop_update(const char *package);
  * @retval	AIL_ERROR_FAIL					internal error
  * @retval 	AIL_ERROR_INVALID_PARAMETER		invalid parameter
  *
- * @pre no pre-condition.
- * @post package information is removed in the Application Information Database.
+ * @pre a desktop file for the package has to be installed in the desktop directory before using this API.
+ * @post update a package information in the Application Information Database.
  *
- * @see  ail_desktop_add(), ail_desktop_update()
+ * @see  ail_desktop_add(), ail_desktop_remove()
  *
  * @par Prospective Clients:
  * External Apps.
  *
  * @code
-static ail_error_e _remove_desktop(const char *package)
+static ail_error_e _update_desktop(const char *package)
 {
 	ail_error_e ret;
 
@@ -1082,7 +1499,7 @@ static ail_error_e _remove_desktop(const char *package)
 		return AIL_ERROR_FAIL;
 	}
 
-	ret = ail_desktop_remove(package);
+	ret = ail_desktop_update(package);
 	if (ret != AIL_ERROR_OK) {
 		return AIL_ERROR_FAIL;
 	}
@@ -1091,7 +1508,1433 @@ static ail_error_e _remove_desktop(const char *package)
 }
  * @endcode
  */
-ail_error_e ail_desktop_remove(const char *package);
+ail_error_e ail_desktop_update(const char *package);
+
+
+
+/**
+ * @fn ail_error_e ail_desktop_remove(const char *package)
+ *
+ * @brief remove a package information in the Application Information Database.
+	And a notification is published to the applications who want to know about changing DB. 
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] package package name
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					internal error
+ * @retval 	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre no pre-condition.
+ * @post package information is removed in the Application Information Database.
+ *
+ * @see  ail_desktop_add(), ail_desktop_update()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static ail_error_e _remove_desktop(const char *package)
+{
+	ail_error_e ret;
+
+	if (!package) {
+		return AIL_ERROR_FAIL;
+	}
+
+	ret = ail_desktop_remove(package);
+	if (ret != AIL_ERROR_OK) {
+		return AIL_ERROR_FAIL;
+	}
+
+	return AIL_ERROR_OK;
+}
+ * @endcode
+ */
+ail_error_e ail_desktop_remove(const char *package);
+
+
+
+/**
+ * @fn ail_error_e ail_desktop_batch_begin(void)
+ *
+ * @brief start a batch of changes of the calling thread.
+	Until the matching ail_desktop_batch_end(), ail_desktop_add(), ail_desktop_update() and ail_desktop_remove()
+	still commit each package and move the generation, but send no change notification.
+	The snapshot is withdrawn at the first change, readers go to the database until the batch ends and publishes it again.
+	This slows down the snapshot readers of every process, not only the calling one, so keep batches short.
+	Batches may nest, only the outermost one publishes.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post ail_desktop_batch_end() must be called by the same thread.
+ *
+ * @see  ail_desktop_batch_end(), ail_changes_subscribe()
+ *
+ * @par Prospective Clients:
+ * Package manager.
+ *
+ * @code
+static ail_error_e _install_bundle(const char **packages, int n)
+{
+	int i;
+
+	ail_desktop_batch_begin();
+	for (i = 0; i < n; i++)
+		ail_desktop_add(packages[i]);
+
+	return ail_desktop_batch_end();
+}
+ * @endcode
+ */
+ail_error_e ail_desktop_batch_begin(void);
+
+
+
+/**
+ * @fn ail_error_e ail_desktop_batch_end(void)
+ *
+ * @brief end a batch of changes started with ail_desktop_batch_begin().
+	If the batch changed anything, the snapshot is republished once and a single notification "batch:<first>-<last>" is sent,
+	where first and last are the seqs of the changes in the change journal.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					no batch was started
+ *
+ * @pre ail_desktop_batch_begin() was called by the same thread.
+ * @post None
+ *
+ * @see  ail_desktop_batch_begin(), ail_changes_since()
+ *
+ * @par Prospective Clients:
+ * Package manager.
+ */
+ail_error_e ail_desktop_batch_end(void);
+
+/**
+ * @brief statistics of the appinfo cache
+ */
+typedef struct {
+	int size;				/**< maximum number of cached records, 0 if the cache is disabled */
+	int entries;				/**< number of records in the cache */
+	unsigned long hits;			/**< lookups answered from the cache */
+	unsigned long misses;			/**< lookups that had to go to the database */
+	unsigned long evictions;		/**< records dropped to respect the size limit */
+	unsigned long invalidations;		/**< records dropped because their package changed */
+	unsigned long absent_hits;		/**< lookups answered as not registered without a query */
+} ail_cache_stats_s;
+
+/**
+ * @fn ail_error_e ail_cache_enable(int size)
+ *
+ * @brief enable the process-wide cache of appinfo records, or change its size.
+	Once enabled, ail_get_appinfo() and ail_package_get_appinfo() keep a copy of every record they read
+	and answer later lookups of the same appid or package without touching the database.
+	The least recently used records are dropped when more than size records are cached.
+	A record is dropped as soon as ail_desktop_add(), ail_desktop_update() or ail_desktop_remove() publishes a change for its package.
+	Lookups of an appid or package which is not registered are rejected by an in-memory filter of the registered ones,
+	or by a list of recent absent ids, both rebuilt after any change.
+	Changes published by other processes are seen at the next lookup, through ail_db_get_generation(),
+	or as soon as the change notification arrives while the process runs a main loop.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] size	maximum number of cached records
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post The cache can be disabled with ail_cache_disable()
+ *
+ * @see  ail_cache_disable(), ail_cache_get_stats()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _print_hit_rate(void)
+{
+	ail_cache_stats_s stats;
+	ail_appinfo_h handle;
+	int i;
+
+	ail_cache_enable(64);
+
+	for (i = 0; i < 100; i++) {
+		if (ail_get_appinfo("org.tizen.memo", &handle) == AIL_ERROR_OK)
+			ail_destroy_appinfo(handle);
+	}
+
+	ail_cache_get_stats(&stats);
+	printf("hit rate = %lu/%lu\n", stats.hits, stats.hits + stats.misses);
+}
+ * @endcode
+ */
+ail_error_e ail_cache_enable(int size);
+
+
+
+/**
+ * @fn ail_error_e ail_cache_disable(void)
+ *
+ * @brief disable the appinfo cache and drop all cached records. Statistics are kept.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_cache_enable(), ail_cache_get_stats()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_cache_disable(void);
+
+
+
+/**
+ * @fn ail_error_e ail_cache_get_stats(ail_cache_stats_s *stats)
+ *
+ * @brief get the statistics of the appinfo cache. The hit rate is hits / (hits + misses).
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[out] stats	a out-parameter filled with the current statistics
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_cache_enable(), ail_cache_disable()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_cache_get_stats(ail_cache_stats_s *stats);
+
+/**
+ * @fn ail_error_e ail_snapshot_publish(void)
+ *
+ * @brief publish a read-only snapshot of the Application Information Database.
+	The snapshot is a versioned, memory-mappable file with all appinfo records and a shared string table.
+	It is replaced atomically, never modified in place.
+	Once a snapshot has been published, ail_desktop_add(), ail_desktop_update() and ail_desktop_remove()
+	publish a new one after each change, before the change notification is sent, or at the end of a batch, see ail_desktop_batch_begin().
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					cannot write the snapshot
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre the caller must be allowed to write the database directory.
+ * @post processes which called ail_snapshot_enable() read from the new snapshot.
+ *
+ * @see  ail_snapshot_enable(), ail_snapshot_disable()
+ *
+ * @par Prospective Clients:
+ * Package manager, ail_initdb.
+ */
+ail_error_e ail_snapshot_publish(void);
+
+
+
+/**
+ * @fn ail_error_e ail_snapshot_enable(void)
+ *
+ * @brief answer reads from the published snapshot instead of the database.
+	While enabled, ail_get_appinfo(), ail_package_get_appinfo(), ail_filter_count_appinfo() and
+	ail_filter_list_appinfo_foreach() map the snapshot read-only and share its pages with all other readers.
+	If no valid snapshot is published, or the database changed since it was, they fall back to the database.
+	A read only checks the shared generation counter, see ail_db_get_generation(), while the snapshot is up to date.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post The snapshot mode can be left with ail_snapshot_disable()
+ *
+ * @see  ail_snapshot_publish(), ail_snapshot_disable()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static int _count_visible(void)
+{
+	ail_filter_h filter;
+	int n = 0;
+
+	ail_snapshot_enable();
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return -1;
+
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+	ail_filter_count_appinfo(filter, &n);
+	ail_filter_destroy(filter);
+
+	return n;
+}
+ * @endcode
+ */
+ail_error_e ail_snapshot_enable(void);
+
+
+
+/**
+ * @fn ail_error_e ail_snapshot_disable(void)
+ *
+ * @brief read from the database again and unmap the snapshot.
+	Handles already returned from the snapshot stay valid.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_snapshot_publish(), ail_snapshot_enable()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_snapshot_disable(void);
+
+
+
+/**
+ * @fn ail_error_e ail_db_get_generation(unsigned long long *generation)
+ *
+ * @brief get the generation of the Application Information Database.
+	The generation grows by one each time ail_desktop_add(), ail_desktop_update() or ail_desktop_remove() commits a change,
+	or ail_db_invalidate() is called, in any process, and never goes back, even when the database is recreated.
+	It is read from a small memory-mapped file, without a query, so it is cheap enough to check before every use of derived data:
+	whatever was computed from the database at the same generation is still valid.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[out] generation	a out-parameter filled with the current generation
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_desktop_add(), ail_desktop_update(), ail_desktop_remove()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static unsigned long long seen;
+static int visible = -1;
+
+static int _count_visible(void)
+{
+	unsigned long long now = 0;
+	ail_filter_h filter;
+
+	if (ail_db_get_generation(&now) == AIL_ERROR_OK && now == seen && visible >= 0)
+		return visible;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return -1;
+
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+	ail_filter_count_appinfo(filter, &visible);
+	ail_filter_destroy(filter);
+	seen = now;
+
+	return visible;
+}
+ * @endcode
+ */
+ail_error_e ail_db_get_generation(unsigned long long *generation);
+
+
+
+/**
+ * @brief kind of a change recorded in the change journal
+ */
+typedef enum {
+	AIL_CHANGE_CREATE = 0,		/**< the package was added */
+	AIL_CHANGE_UPDATE = 1,		/**< the package was updated */
+	AIL_CHANGE_DELETE = 2,		/**< the package was removed */
+} ail_change_type_e;
+
+/**
+ * @fn ail_cb_ret_e (*ail_change_cb) (unsigned long long seq, ail_change_type_e type, const char *package, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_changes_since().
+ *
+ * @param[in] seq	sequence number of the change, to pass to the next ail_changes_since()
+ * @param[in] type	kind of the change
+ * @param[in] package	package which changed
+ * @param[in] user_data user data passed to ail_changes_since()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_CB_RET_CONTINUE				return if you continue iteration
+ * @retval	AIL_CB_RET_CANCEL				return if you cancel iteration
+ *
+ * @see  ail_changes_since()
+ */
+typedef ail_cb_ret_e (*ail_change_cb) (unsigned long long seq, ail_change_type_e type, const char *package, void *user_data);
+
+/**
+ * @fn ail_error_e ail_changes_since(unsigned long long seq, ail_change_cb cb, void *user_data)
+ *
+ * @brief Calls the callback function for each change committed after seq, oldest first.
+	ail_desktop_add(), ail_desktop_update() and ail_desktop_remove() record every change in a journal,
+	in the same transaction as the change itself, and number them without gaps.
+	Unlike the change notification, which only holds the last event, the journal lets a client catch up
+	on everything it missed by passing the seq of the last change it handled.
+	Only the most recent changes are kept. If some changes after seq are gone, or the database was recreated,
+	nothing is called and the client has to list all appinfos again.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] seq	seq of the last change already handled, 0 for a client which never listed the changes
+ * @param[in] cb	callback function
+ * @param[in] user_data	user data to pass to the callback function
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ * @retval	AIL_ERROR_EXPIRED				changes after seq are not kept anymore
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_changes_get_latest(), ail_change_cb
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static unsigned long long last;
+
+ail_cb_ret_e _on_change(unsigned long long seq, ail_change_type_e type, const char *package, void *user_data)
+{
+	_update_icon(package, type);
+	last = seq;
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+static void _sync(void)
+{
+	if (ail_changes_since(last, _on_change, NULL) == AIL_ERROR_EXPIRED) {
+		ail_changes_get_latest(&last);
+		_reload_all_icons();
+	}
+}
+ * @endcode
+ */
+ail_error_e ail_changes_since(unsigned long long seq, ail_change_cb cb, void *user_data);
+
+
+
+/**
+ * @fn ail_error_e ail_changes_get_latest(unsigned long long *seq)
+ *
+ * @brief get the seq of the last change recorded in the change journal.
+	A client which lists all appinfos gets it first, then passes it to ail_changes_since() to follow the later changes.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[out] seq	a out-parameter filled with the seq of the last change, 0 if there was none
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_changes_since()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_changes_get_latest(unsigned long long *seq);
+
+
+
+/**
+ * @brief a change delivered to an ail_changes_cb
+ */
+typedef struct {
+	unsigned long long seq;		/**< sequence number in the change journal */
+	ail_change_type_e type;		/**< kind of the change */
+	const char *package;		/**< package which changed */
+} ail_change_s;
+
+/**
+ * @brief A handle for a subscription to the changes
+ */
+typedef struct ail_changes_subscription *ail_changes_subscription_h;
+
+/**
+ * @fn void (*ail_changes_cb) (const ail_change_s *changes, int count, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_changes_subscribe().
+ *
+ * @param[in] changes	the changes, oldest first, valid during the call only. NULL if some changes were lost and everything must be reloaded
+ * @param[in] count	number of changes, 0 if changes is NULL
+ * @param[in] user_data user data passed to ail_changes_subscribe()
+ *
+ * @see  ail_changes_subscribe()
+ */
+typedef void (*ail_changes_cb) (const ail_change_s *changes, int count, void *user_data);
+
+/**
+ * @fn ail_error_e ail_changes_subscribe(int interval_ms, ail_changes_cb cb, void *user_data, ail_changes_subscription_h *subscription)
+ *
+ * @brief Calls the callback function with the list of changes committed by any process, at most once every interval_ms.
+	The first change notification starts a timer of interval_ms, and when it fires every change after the last delivered one
+	is read from the change journal and passed in a single call.
+	Later notifications do not restart the timer, a steady stream of changes is still delivered every interval_ms.
+	Installing a bundle of packages therefore wakes the subscriber once, even without ail_desktop_batch_begin().
+	Changes are never lost when notifications overwrite each other, and each one is delivered exactly once.
+ *
+ * @par Sync (or) Async : Asynchronous API, the callback is called from the default main loop.
+ *
+ * @param[in] interval_ms	delay between the first notification and the delivery, 0 to deliver once the main loop is idle
+ * @param[in] cb	callback function
+ * @param[in] user_data	user data to pass to the callback function
+ * @param[out] subscription	a out-parameter filled with the new subscription
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					cannot watch the notifications
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre a main loop must run in the calling thread, which is the only one to use the subscription functions.
+ * @post the subscription must be released with ail_changes_unsubscribe()
+ *
+ * @see  ail_changes_unsubscribe(), ail_changes_since(), ail_desktop_batch_begin()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _on_changes(const ail_change_s *changes, int count, void *user_data)
+{
+	int i;
+
+	if (!changes) {
+		_reload_all_icons();
+		return;
+	}
+
+	for (i = 0; i < count; i++)
+		_update_icon(changes[i].package, changes[i].type);
+}
+
+static ail_changes_subscription_h _watch(void)
+{
+	ail_changes_subscription_h sub = NULL;
+
+	ail_changes_subscribe(300, _on_changes, NULL, &sub);
+
+	return sub;
+}
+ * @endcode
+ */
+ail_error_e ail_changes_subscribe(int interval_ms, ail_changes_cb cb, void *user_data,
+		ail_changes_subscription_h *subscription);
+
+
+
+/**
+ * @fn ail_error_e ail_changes_unsubscribe(ail_changes_subscription_h subscription)
+ *
+ * @brief stop a subscription, pending changes are not delivered.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] subscription	the subscription returned by ail_changes_subscribe()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post subscription must not be used anymore
+ *
+ * @see  ail_changes_subscribe()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_changes_unsubscribe(ail_changes_subscription_h subscription);
+
+
+
+/**
+ * @brief how a row changed relative to a watched filter
+ */
+typedef enum {
+	AIL_FILTER_MATCH_ADDED = 0,		/**< the package matches the filter now, and did not before */
+	AIL_FILTER_MATCH_REMOVED = 1,		/**< the package matched the filter, and does not anymore or was removed */
+	AIL_FILTER_MATCH_MODIFIED = 2,		/**< the package still matches the filter, and was updated */
+} ail_filter_match_e;
+
+/**
+ * @brief A handle for a watched filter
+ */
+typedef struct ail_filter_watch *ail_filter_watch_h;
+
+/**
+ * @fn void (*ail_filter_watch_cb) (ail_filter_match_e match, const char *package, const ail_appinfo_h appinfo, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_filter_watch().
+ *
+ * @param[in] match	how the matches of the filter changed
+ * @param[in] package	package which changed
+ * @param[in] appinfo	the appinfo's handle with the new values, valid during the call only. NULL for AIL_FILTER_MATCH_REMOVED
+ * @param[in] user_data user data passed to ail_filter_watch()
+ *
+ * @see  ail_filter_watch()
+ */
+typedef void (*ail_filter_watch_cb) (ail_filter_match_e match, const char *package, const ail_appinfo_h appinfo, void *user_data);
+
+/**
+ * @fn ail_error_e ail_filter_watch(ail_filter_h filter, ail_filter_watch_cb cb, void *user_data, ail_filter_watch_h *watch)
+ *
+ * @brief Calls the callback function for each package which starts or stops matching the filter, or is updated while it matches.
+	The packages matching the filter are recorded when the watch starts.
+	After each change notification, only the packages named in the change journal are evaluated again, with one query,
+	and compared with the recorded ones. Changes to other packages cost nothing.
+	If some changes were lost, every row is evaluated again and each package still matching is reported as modified.
+	The filter is copied and may be destroyed once the function returns.
+ *
+ * @par Sync (or) Async : Asynchronous API, the callback is called from the default main loop.
+ *
+ * @param[in] filter	the filter to watch, must not be NULL
+ * @param[in] cb	callback function
+ * @param[in] user_data	user data to pass to the callback function
+ * @param[out] watch	a out-parameter filled with the new watch
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					internal error
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre A main loop must run in the calling thread.
+ * @post the watch must be released with ail_filter_unwatch()
+ *
+ * @see  ail_filter_unwatch(), ail_changes_subscribe(), ail_filter_list_appinfo_foreach()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _on_match(ail_filter_match_e match, const char *package, const ail_appinfo_h appinfo, void *user_data)
+{
+	char *name;
+
+	switch (match) {
+	case AIL_FILTER_MATCH_ADDED:
+	case AIL_FILTER_MATCH_MODIFIED:
+		ail_appinfo_get_str(appinfo, AIL_PROP_NAME_STR, &name);
+		_show_icon(package, name);
+		break;
+	case AIL_FILTER_MATCH_REMOVED:
+		_hide_icon(package);
+		break;
+	}
+}
+
+static ail_filter_watch_h _watch_visible(ail_filter_h filter)
+{
+	ail_filter_watch_h watch = NULL;
+
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+	ail_filter_watch(filter, _on_match, NULL, &watch);
+
+	return watch;
+}
+ * @endcode
+ */
+ail_error_e ail_filter_watch(ail_filter_h filter, ail_filter_watch_cb cb, void *user_data,
+		ail_filter_watch_h *watch);
+
+
+
+/**
+ * @fn ail_error_e ail_filter_unwatch(ail_filter_watch_h watch)
+ *
+ * @brief stop watching a filter. It may be called from the callback of the watch.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] watch	the watch returned by ail_filter_watch()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post watch must not be used anymore, its filter may be destroyed.
+ *
+ * @see  ail_filter_watch()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_filter_unwatch(ail_filter_watch_h watch);
+
+
+
+/**
+ * @brief A handle for an asynchronous request
+ */
+typedef struct ail_request *ail_request_h;
+
+/**
+ * @fn void (*ail_get_appinfo_cb) (ail_error_e result, ail_appinfo_h appinfo, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_get_appinfo_async().
+ *
+ * @param[in] result	what ail_get_appinfo() returned
+ * @param[in] appinfo	the appinfo's handle if result is AIL_ERROR_OK, NULL otherwise. It must be released with ail_destroy_appinfo()
+ * @param[in] user_data user data passed to ail_get_appinfo_async()
+ *
+ * @see  ail_get_appinfo_async()
+ */
+typedef void (*ail_get_appinfo_cb) (ail_error_e result, ail_appinfo_h appinfo, void *user_data);
+
+/**
+ * @fn void (*ail_list_appinfo_batch_cb) (ail_error_e result, const ail_appinfo_h *appinfos, int count, bool done, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_filter_list_appinfo_async().
+ *
+ * @param[in] result	AIL_ERROR_OK, or the error which ended the listing in the last batch
+ * @param[in] appinfos	the appinfos' handles of this batch, valid during the call only
+ * @param[in] count	number of handles, may be 0 in the last batch
+ * @param[in] done	true for the last batch
+ * @param[in] user_data user data passed to ail_filter_list_appinfo_async()
+ *
+ * @see  ail_filter_list_appinfo_async()
+ */
+typedef void (*ail_list_appinfo_batch_cb) (ail_error_e result, const ail_appinfo_h *appinfos, int count, bool done, void *user_data);
+
+/**
+ * @fn ail_error_e ail_get_appinfo_async(const char *appid, GMainContext *context, ail_get_appinfo_cb cb, void *user_data, ail_request_h *request)
+ *
+ * @brief run ail_get_appinfo() on a worker thread of the library, and call the callback from context with the result.
+	The calling thread never waits for the database, even when it is cold or locked by a writer.
+ *
+ * @par Sync (or) Async : Asynchronous API.
+ *
+ * @param[in] appid	appid
+ * @param[in] context	main context to call the callback from, NULL for the default one
+ * @param[in] cb	callback function, called exactly once unless the request is cancelled
+ * @param[in] user_data	user data to pass to the callback function
+ * @param[out] request	a out-parameter filled with the request, valid until the callback returns or ail_request_cancel()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					cannot start the worker threads
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_get_appinfo(), ail_request_cancel()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _on_appinfo(ail_error_e result, ail_appinfo_h appinfo, void *user_data)
+{
+	char *name;
+
+	if (result != AIL_ERROR_OK)
+		return;
+
+	ail_appinfo_get_str(appinfo, AIL_PROP_NAME_STR, &name);
+	_set_title(user_data, name);
+	ail_destroy_appinfo(appinfo);
+}
+
+static void _show_title(void *view, const char *appid)
+{
+	ail_request_h request;
+
+	ail_get_appinfo_async(appid, NULL, _on_appinfo, view, &request);
+}
+ * @endcode
+ */
+ail_error_e ail_get_appinfo_async(const char *appid, GMainContext *context,
+		ail_get_appinfo_cb cb, void *user_data, ail_request_h *request);
+
+
+
+/**
+ * @fn ail_error_e ail_filter_list_appinfo_async(ail_filter_h filter, int batch_size, GMainContext *context, ail_list_appinfo_batch_cb cb, void *user_data, ail_request_h *request)
+ *
+ * @brief run ail_filter_list_appinfo_foreach() on a worker thread of the library, and call the callback from context with batches of the results.
+	The filter is copied and may be destroyed once the function returns.
+	Batches are delivered in order while the worker is still reading, the last one has done set.
+ *
+ * @par Sync (or) Async : Asynchronous API.
+ *
+ * @param[in] filter	filter handle, NULL for all packages
+ * @param[in] batch_size	maximum number of appinfos per batch, 0 or less for the default
+ * @param[in] context	main context to call the callback from, NULL for the default one
+ * @param[in] cb	callback function
+ * @param[in] user_data	user data to pass to the callback function
+ * @param[out] request	a out-parameter filled with the request, valid until the last batch is delivered or ail_request_cancel()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					cannot start the worker threads
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_filter_list_appinfo_foreach(), ail_request_cancel()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _on_batch(ail_error_e result, const ail_appinfo_h *appinfos, int count, bool done, void *user_data)
+{
+	char *package;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		ail_appinfo_get_str(appinfos[i], AIL_PROP_PACKAGE_STR, &package);
+		_add_icon(user_data, package);
+	}
+
+	if (done)
+		_hide_progress(user_data);
+}
+
+static ail_request_h _fill_grid(void *grid)
+{
+	ail_request_h request = NULL;
+	ail_filter_h filter;
+
+	if (ail_filter_new(&filter) != AIL_ERROR_OK)
+		return NULL;
+
+	ail_filter_add_bool(filter, AIL_PROP_NODISPLAY_BOOL, false);
+	ail_filter_list_appinfo_async(filter, 16, NULL, _on_batch, grid, &request);
+	ail_filter_destroy(filter);
+
+	return request;
+}
+ * @endcode
+ */
+ail_error_e ail_filter_list_appinfo_async(ail_filter_h filter, int batch_size,
+		GMainContext *context, ail_list_appinfo_batch_cb cb, void *user_data,
+		ail_request_h *request);
+
+
+
+/**
+ * @fn ail_error_e ail_request_cancel(ail_request_h request)
+ *
+ * @brief cancel an asynchronous request. No callback of the request is called afterwards.
+	A worker reading a list stops at the next row.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] request	the request, before its last callback returned
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre it must be called from the thread which runs the context of the request.
+ * @post request must not be used anymore
+ *
+ * @see  ail_get_appinfo_async(), ail_filter_list_appinfo_async()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_request_cancel(ail_request_h request);
+
+
+
+/**
+ * @brief A handle for a library context, which owns a pool of database connections
+ */
+typedef struct ail_context *ail_context_h;
+
+/**
+ * @brief configuration of a library context, 0 in a field selects its default
+ */
+typedef struct {
+	int max_connections;		/**< read-only connections shared by all threads, 4 by default */
+	int idle_timeout;		/**< seconds after which an unused connection is closed, 30 by default */
+	int wait_ms;			/**< milliseconds a read waits for a free connection before it fails, 5000 by default */
+} ail_context_config_s;
+
+/**
+ * @fn ail_error_e ail_context_create(const ail_context_config_s *config, ail_context_h *context)
+ *
+ * @brief create a library context.
+	Reads lease a read-only connection from the context of the calling thread for as long as they run,
+	and return it to the context afterwards, so any number of threads shares at most max_connections connections and page caches.
+	A read started from the callback of another read of the same thread shares its connection.
+	A read is leased its connection until its callbacks return. When all of them are leased, a read waits up to wait_ms for one,
+	then fails with AIL_ERROR_DB_FAILED. Threads which spend long in callbacks need a larger max_connections.
+	Connections unused for idle_timeout seconds are closed when a read leases or returns one.
+	Threads which never called ail_context_set_thread_default() use an implicit default context.
+	Writes still use one connection per writing thread.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] config	configuration of the context, NULL for the defaults
+ * @param[out] context	a out-parameter filled with the new context
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post The context must be released with ail_context_destroy()
+ *
+ * @see  ail_context_destroy(), ail_context_set_thread_default()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static ail_context_h context;
+
+static void _init(void)
+{
+	ail_context_config_s config = {
+		.max_connections = 2,
+		.idle_timeout = 10,
+	};
+
+	ail_context_create(&config, &context);
+}
+
+static void *_worker(void *data)
+{
+	ail_context_set_thread_default(context);
+
+	return _serve(data);
+}
+ * @endcode
+ */
+ail_error_e ail_context_create(const ail_context_config_s *config, ail_context_h *context);
+
+
+
+/**
+ * @fn ail_error_e ail_context_destroy(ail_context_h context)
+ *
+ * @brief close the connections of a library context and destroy it.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] context	the context
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_FAIL					a read still uses a connection of the context
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre no thread other than the caller uses context as its default anymore.
+ * @post context must not be used anymore
+ *
+ * @see  ail_context_create()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_context_destroy(ail_context_h context);
+
+
+
+/**
+ * @fn ail_error_e ail_context_set_thread_default(ail_context_h context)
+ *
+ * @brief select the library context used by the reads of the calling thread.
+	A read already running keeps the connection it leased.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] context	the context, NULL for the implicit default context
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_context_create()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_context_set_thread_default(ail_context_h context);
+
+
+
+/**
+ * @brief where SQLite keeps temporary tables and indices
+ */
+typedef enum {
+	AIL_DB_TEMP_STORE_DEFAULT = 0,	/**< SQLite's compile-time default */
+	AIL_DB_TEMP_STORE_FILE,		/**< temporary files */
+	AIL_DB_TEMP_STORE_MEMORY,	/**< memory */
+} ail_db_temp_store_e;
+
+/**
+ * @brief how often SQLite syncs the database file to the storage
+ */
+typedef enum {
+	AIL_DB_SYNCHRONOUS_DEFAULT = 0,	/**< SQLite's default, FULL */
+	AIL_DB_SYNCHRONOUS_OFF,		/**< never, a power loss can corrupt the database */
+	AIL_DB_SYNCHRONOUS_NORMAL,	/**< at critical moments only */
+	AIL_DB_SYNCHRONOUS_FULL,	/**< at the end of every transaction */
+} ail_db_synchronous_e;
+
+/**
+ * @brief memory and I/O tuning of the database connections, 0 in a field leaves the SQLite default
+ */
+typedef struct {
+	int cache_size_kb;			/**< page cache of each connection, in KiB */
+	long long mmap_size;			/**< bytes of the database file read through mmap */
+	ail_db_temp_store_e temp_store;		/**< storage of temporary tables */
+	ail_db_synchronous_e synchronous;	/**< sync policy of the writes */
+} ail_db_config_s;
+
+/**
+ * @fn ail_error_e ail_db_config(const ail_db_config_s *config)
+ *
+ * @brief set the memory and I/O tuning of every database connection of the process.
+	Connections already open apply it the next time they are used, new ones when they are opened.
+	Without a call, the tuning is read from /opt/dbspace/.app_info.conf, lines of "key = value" with the keys
+	cache_size_kb, mmap_size, temp_store (default, file or memory) and synchronous (default, off, normal or full),
+	then from the environment variables AIL_DB_CACHE_SIZE_KB, AIL_DB_MMAP_SIZE, AIL_DB_TEMP_STORE and AIL_DB_SYNCHRONOUS, which take precedence.
+	A call replaces the whole tuning, including what was read from the file and the environment.
+	A field set back to 0 applies to new connections only; open ones keep their last value.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] config	the tuning
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_db_get_config()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+...
+	ail_db_config_s config;
+
+	// A bigger page cache and mmap for a lookup-heavy launcher
+	ail_db_get_config(&config);
+	config.cache_size_kb = 4096;
+	config.mmap_size = 16 * 1024 * 1024;
+	ail_db_config(&config);
+...
+ * @endcode
+ */
+ail_error_e ail_db_config(const ail_db_config_s *config);
+
+
+
+/**
+ * @fn ail_error_e ail_db_get_config(ail_db_config_s *config)
+ *
+ * @brief get the memory and I/O tuning of the database connections of the process.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[out] config	a out-parameter filled with the tuning
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_db_config()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_db_get_config(ail_db_config_s *config);
+
+
+
+/**
+ * @fn ail_error_e ail_db_upgrade(void)
+ *
+ * @brief upgrade the schema of the Application Information Database to the one of the library.
+	The schema is upgraded when a process first opens the database for writing.
+	Readers of a database left with an older schema fail on the tables added since, until some process writes to it.
+	This API upgrades it without a change, to be called once the library is updated.
+	A database without tables is left as is.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre the caller must be allowed to write the database.
+ * @post None
+ *
+ * @par Prospective Clients:
+ * ail_initdb.
+ */
+ail_error_e ail_db_upgrade(void);
+
+
+
+/**
+ * @fn ail_error_e ail_db_invalidate(void)
+ *
+ * @brief move the generation of the Application Information Database on, without a change.
+	Caches and snapshot readers of every process drop what they read at older generations.
+	To be called after the database file was replaced behind the library, e.g. restored from a copy.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_DB_FAILED				database error
+ *
+ * @pre the caller must be allowed to write the database.
+ * @post a published snapshot is left to the database readers until ail_snapshot_publish() is called again.
+ *
+ * @see  ail_db_get_generation(), ail_snapshot_publish()
+ *
+ * @par Prospective Clients:
+ * ail_replay.
+ */
+ail_error_e ail_db_invalidate(void);
+
+
+
+/**
+ * @brief statistics of the queries sharing a shape, the SQL with its literals replaced by ?
+ */
+typedef struct {
+	const char *query;			/**< the shape of the queries */
+	unsigned long count;			/**< executions */
+	unsigned long long rows;		/**< rows returned by all executions */
+	unsigned long long total_us;		/**< microseconds spent in all executions */
+	unsigned long long p50_us;		/**< median latency, rounded up to a power of two */
+	unsigned long long p90_us;		/**< 90th percentile latency, rounded up to a power of two */
+	unsigned long long p99_us;		/**< 99th percentile latency, rounded up to a power of two */
+	unsigned long long max_us;		/**< slowest execution */
+} ail_query_stats_s;
+
+/**
+ * @fn ail_cb_ret_e (*ail_stats_cb) (const ail_query_stats_s *stats, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_stats_get().
+ *
+ * @param[in] stats	statistics of a query shape, valid during the callback only
+ * @param[in] user_data user data passed to ail_stats_get()
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_CB_RET_CONTINUE				return if you continue iteration
+ * @retval	AIL_CB_RET_CANCEL				return if you cancel iteration
+ *
+ * @see  ail_stats_get()
+ */
+typedef ail_cb_ret_e (*ail_stats_cb) (const ail_query_stats_s *stats, void *user_data);
+
+/**
+ * @fn ail_error_e ail_stats_get(ail_stats_cb cb, void *user_data)
+ *
+ * @brief get the statistics of the queries run by the process since its start or the last ail_stats_reset().
+	Executions are grouped by shape, so queries differing only in their values are counted together.
+	A query is timed from its preparation to its end, including every row it stepped through.
+	The shapes are passed to cb from the most to the least total time.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] cb	the function called for each shape
+ * @param[in] user_data	user data passed to cb
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_stats_dump(), ail_stats_reset(), ail_stats_set_slow_threshold()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static ail_cb_ret_e _top_cb(const ail_query_stats_s *stats, void *user_data)
+{
+	int *n = user_data;
+
+	printf("%llu us in %lu runs: %s\n", stats->total_us, stats->count, stats->query);
+
+	return --(*n) ? AIL_CB_RET_CONTINUE : AIL_CB_RET_CANCEL;
+}
+
+static void _print_top_queries(void)
+{
+	int n = 5;
+
+	ail_stats_get(_top_cb, &n);
+}
+ * @endcode
+ */
+ail_error_e ail_stats_get(ail_stats_cb cb, void *user_data);
+
+
+
+/**
+ * @fn ail_error_e ail_stats_dump(int fd)
+ *
+ * @brief write the statistics of ail_stats_get() to fd as a table, one line per query shape.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] fd	a file descriptor open for writing
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_stats_get()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_stats_dump(int fd);
+
+
+
+/**
+ * @fn ail_error_e ail_stats_reset(void)
+ *
+ * @brief forget the statistics of the queries and of the lock waits so far.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_stats_get()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_stats_reset(void);
+
+
+
+/**
+ * @fn ail_error_e ail_stats_set_slow_threshold(int ms)
+ *
+ * @brief set the duration from which a query is logged as slow, with its SQL and its EXPLAIN QUERY PLAN.
+	The default is 100 ms, or the AIL_DB_SLOW_QUERY_MS environment variable if it is set.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] ms	the threshold in milliseconds, 0 to log no query
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_stats_get()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_stats_set_slow_threshold(int ms);
+
+
+
+/**
+ * @brief statistics of the waits for database locks held by other connections
+ */
+typedef struct {
+	unsigned long waits;			/**< statements which found the database locked */
+	unsigned long retries;			/**< sleeps while waiting for a lock */
+	unsigned long long wait_us;		/**< microseconds spent waiting for locks */
+	unsigned long timeouts;			/**< waits given up after 5 s, their statement failed */
+} ail_busy_stats_s;
+
+/**
+ * @fn ail_error_e ail_stats_get_busy(ail_busy_stats_s *stats)
+ *
+ * @brief get the statistics of the waits of the process for database locks since its start or the last ail_stats_reset().
+	A statement finding the database locked by a writer, or by readers while it writes, retries with a growing sleep for up to 5 s.
+	The waits are only counted by processes started with the AIL_DB_BUSY_STATS environment variable set to 1,
+	whose connections wait with a handler of the library instead of the one of db-util. Other processes report zeros.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[out] stats	a out-parameter filled with the statistics
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_INVALID_PARAMETER		invalid parameter
+ *
+ * @pre None
+ * @post None
+ *
+ * @see  ail_stats_get(), ail_stats_reset()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ */
+ail_error_e ail_stats_get_busy(ail_busy_stats_s *stats);
+
+
+
+/**
+ * @brief hot paths of the library reported to a trace hook
+ */
+typedef enum {
+	AIL_TRACE_DB_OPEN = 0,		/**< opening a database connection, detail is "ro" or "rw" */
+	AIL_TRACE_DB_PREPARE,		/**< compiling a query, detail is its SQL */
+	AIL_TRACE_DB_STEP,		/**< fetching a row of a query, detail is its SQL */
+	AIL_TRACE_ROW_FILL,		/**< copying a row into an appinfo, no detail */
+	AIL_TRACE_DESKTOP_PARSE,	/**< parsing a desktop file, detail is its path */
+	AIL_TRACE_ICON_RESOLVE,		/**< resolving the path of an icon, detail is the icon of the desktop file */
+	AIL_TRACE_MIME_UNALIAS,		/**< resolving a MIME type alias, detail is the type */
+	AIL_TRACE_NOTIFY_SEND,		/**< notifying other processes of a change, detail is the notification */
+} ail_trace_point_e;
+
+/**
+ * @brief whether a trace point is entered or left
+ */
+typedef enum {
+	AIL_TRACE_BEGIN = 0,	/**< entering the trace point */
+	AIL_TRACE_END,		/**< leaving the trace point */
+} ail_trace_phase_e;
+
+/**
+ * @fn void (*ail_trace_cb) (ail_trace_point_e point, ail_trace_phase_e phase, const char *detail, void *user_data)
+ *
+ * @brief Specifies the type of functions passed to ail_trace_set_hook().
+	It is called on the thread running the traced code, so it must be quick and must not call the library.
+ *
+ * @param[in] point	the trace point
+ * @param[in] phase	AIL_TRACE_BEGIN when entering the point, AIL_TRACE_END when leaving it
+ * @param[in] detail	what the point works on, or NULL, valid during the callback only
+ * @param[in] user_data user data passed to ail_trace_set_hook()
+ *
+ * @see  ail_trace_set_hook()
+ */
+typedef void (*ail_trace_cb) (ail_trace_point_e point, ail_trace_phase_e phase, const char *detail, void *user_data);
+
+/**
+ * @fn ail_error_e ail_trace_set_hook(ail_trace_cb cb, void *user_data)
+ *
+ * @brief set the function called when the library enters and leaves each trace point, for example to emit profiler events.
+	Every AIL_TRACE_BEGIN is followed by the AIL_TRACE_END of the same point on the same thread, and points of one thread nest.
+	Without a hook, a trace point costs a single test of a flag.
+ *
+ * @par Sync (or) Async : Synchronous API.
+ *
+ * @param[in] cb	the hook, NULL to remove it
+ * @param[in] user_data	user data passed to cb
+ *
+ * @return 0 if success, negative value(<0) if fail\n
+ * @retval	AIL_ERROR_OK					success
+ * @retval	AIL_ERROR_OUT_OF_MEMORY			out of memory
+ *
+ * @pre no other thread is inside the library, or a point it entered before the call may be left without a call to cb.
+ * @post None
+ *
+ * @see  ail_stats_get()
+ *
+ * @par Prospective Clients:
+ * External Apps.
+ *
+ * @code
+static void _trace_cb(ail_trace_point_e point, ail_trace_phase_e phase, const char *detail, void *user_data)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	fprintf(user_data, "%ld.%09ld %d %c %s\n", ts.tv_sec, ts.tv_nsec, point,
+			phase == AIL_TRACE_BEGIN ? 'B' : 'E', detail ? detail : "");
+}
+
+...
+	ail_trace_set_hook(_trace_cb, stderr);
+...
+ * @endcode
+ */
+ail_error_e ail_trace_set_hook(ail_trace_cb cb, void *user_data);
 
 /** @} */
 
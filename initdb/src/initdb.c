@@ -35,9 +35,9 @@
 #define OWNER_ROOT 0
 #define GROUP_MENU 6010
 #define BUFSZE 1024
-#define OPT_DESKTOP_DIRECTORY "/opt/share/applications"
-#define USR_DESKTOP_DIRECTORY "/usr/share/applications"
-#define APP_INFO_DB_FILE "/opt/dbspace/.app_info.db"
+#define OPT_DESKTOP_DIRECTORY AIL_ROOT"/opt/share/applications"
+#define USR_DESKTOP_DIRECTORY AIL_ROOT"/usr/share/applications"
+#define APP_INFO_DB_FILE AIL_ROOT"/opt/dbspace/.app_info.db"
 
 #ifdef _E
 #undef _E
@@ -166,6 +166,11 @@ static int initdb_change_perm(const char *db_file)
 
 	retv_if(!db_file, AIL_ERROR_FAIL);
 
+#ifdef AIL_HOST
+	/* No menu group on a host */
+	return AIL_ERROR_OK;
+#endif
+
 	snprintf(journal_file, sizeof(journal_file), "%s%s", db_file, "-journal");
 
 	for (i = 0; files[i]; i++) {
@@ -192,17 +197,23 @@ static int __is_authorized()
 {
 	/* ail_init db should be called by as root privilege. */
 
+#ifdef AIL_HOST
+	/* The DB of a host build belongs to the developer */
+	return 1;
+#else
 	uid_t uid = getuid();
 	if ((uid_t) 0 == uid)
 		return 1;
 	else
 		return 0;
+#endif
 }
 
 
 int main(int argc, char *argv[])
 {
 	int ret;
+	int snapshot;
 
 	if (!__is_authorized()) {
 		fprintf(stderr, "You are not an authorized user!\n");
@@ -213,30 +224,54 @@ int main(int argc, char *argv[])
 	ret = setenv("AIL_INITDB", "1", 1);
 	_D("AIL_INITDB : %d", ret);
 
+	/* The library may have been updated over an existing DB */
+	ret = ail_db_upgrade();
+	if (ret != AIL_ERROR_OK) {
+		_E("cannot upgrade the App Info DB.");
+		return AIL_ERROR_FAIL;
+	}
+
 	ret = initdb_count_app();
 	if (ret > 0) {
 		_D("Some Apps in the App Info DB.");
 		return AIL_ERROR_OK;
 	}
 
+	/* A snapshot left from an old DB must not be served while loading */
+	snapshot = (access(APP_INFO_SNAPSHOT, F_OK) == 0);
+	if (snapshot)
+		unlink(APP_INFO_SNAPSHOT);
+
+	/* One notification for the whole load */
+	ail_desktop_batch_begin();
+
 	ret = initdb_load_directory(OPT_DESKTOP_DIRECTORY);
 	if (ret == AIL_ERROR_FAIL) {
 		_E("cannot load opt desktop directory.");
+		ail_desktop_batch_end();
 		return AIL_ERROR_FAIL;
 	}
 
 	ret = initdb_load_directory(USR_DESKTOP_DIRECTORY);
 	if (ret == AIL_ERROR_FAIL) {
 		_E("cannot load usr desktop directory.");
+		ail_desktop_batch_end();
 		return AIL_ERROR_FAIL;
 	}
 
+	ail_desktop_batch_end();
+
 	ret = initdb_change_perm(APP_INFO_DB_FILE);
 	if (ret == AIL_ERROR_FAIL) {
 		_E("cannot chown.");
 		return AIL_ERROR_FAIL;
 	}
 
+	if (snapshot && ail_snapshot_publish() != AIL_ERROR_OK) {
+		_E("cannot publish the snapshot.");
+		return AIL_ERROR_FAIL;
+	}
+
 	return AIL_ERROR_OK;
 }
 
@@ -0,0 +1,357 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_package.h"
+#include "ail_filter.h"
+
+/* Workers keep their connections, db_info is per thread */
+#define ASYNC_THREADS		2
+#define ASYNC_BATCH_DEFAULT	32
+
+typedef enum {
+	ASYNC_GET_APPINFO,
+	ASYNC_LIST_APPINFO,
+} async_type;
+
+struct ail_request {
+	int ref;		/* user until the end or a cancel, worker, queued batches */
+	int cancelled;
+	async_type type;
+	char *appid;
+	ail_filter_h filter;
+	int batch_size;
+	GPtrArray *pending;	/* batch the worker is filling */
+	GMainContext *context;
+	ail_get_appinfo_cb get_cb;
+	ail_list_appinfo_batch_cb list_cb;
+	void *user_data;
+};
+
+struct batch {
+	ail_request_h req;
+	ail_error_e result;
+	GPtrArray *appinfos;
+	bool done;
+};
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static GThreadPool *pool;
+
+
+
+static void _ref(ail_request_h req)
+{
+	__atomic_add_fetch(&req->ref, 1, __ATOMIC_RELAXED);
+}
+
+
+
+static void _unref(ail_request_h req)
+{
+	if (__atomic_sub_fetch(&req->ref, 1, __ATOMIC_ACQ_REL))
+		return;
+
+	if (req->filter)
+		ail_filter_destroy(req->filter);
+	SAFE_FREE(req->appid);
+	g_main_context_unref(req->context);
+	free(req);
+}
+
+
+
+static inline bool _is_cancelled(ail_request_h req)
+{
+	return __atomic_load_n(&req->cancelled, __ATOMIC_ACQUIRE);
+}
+
+
+
+static void _free_appinfos(GPtrArray *appinfos)
+{
+	int i;
+
+	for (i = 0; i < appinfos->len; i++) {
+		if (appinfos->pdata[i])
+			ail_destroy_appinfo(appinfos->pdata[i]);
+	}
+	g_ptr_array_free(appinfos, TRUE);
+}
+
+
+
+static void _free_batch(gpointer data)
+{
+	struct batch *b = data;
+
+	_free_appinfos(b->appinfos);
+	_unref(b->req);
+	free(b);
+}
+
+
+
+static gboolean _deliver(gpointer data)
+{
+	struct batch *b = data;
+	ail_request_h req = b->req;
+	ail_appinfo_h ai;
+
+	if (_is_cancelled(req))
+		return FALSE;
+
+	if (ASYNC_GET_APPINFO == req->type) {
+		/* The callback owns the handle, as after ail_get_appinfo() */
+		ai = b->appinfos->len ? b->appinfos->pdata[0] : NULL;
+		g_ptr_array_set_size(b->appinfos, 0);
+		req->get_cb(b->result, ai, req->user_data);
+	} else {
+		req->list_cb(b->result, (const ail_appinfo_h *)b->appinfos->pdata,
+				b->appinfos->len, b->done, req->user_data);
+	}
+
+	/* The user's reference, unless the callback cancelled and dropped it */
+	if (b->done && !_is_cancelled(req))
+		_unref(req);
+
+	return FALSE;
+}
+
+
+
+static void _post(ail_request_h req, ail_error_e result, GPtrArray *appinfos, bool done)
+{
+	struct batch *b;
+	GSource *source;
+
+	b = calloc(1, sizeof(struct batch));
+	if (!b) {
+		_E("Cannot deliver a batch, out of memory");
+		_free_appinfos(appinfos);
+		return;
+	}
+
+	_ref(req);
+	b->req = req;
+	b->result = result;
+	b->appinfos = appinfos;
+	b->done = done;
+
+	source = g_idle_source_new();
+	g_source_set_callback(source, _deliver, b, _free_batch);
+	g_source_attach(source, req->context);
+	g_source_unref(source);
+}
+
+
+
+static ail_cb_ret_e _collect(const ail_appinfo_h appinfo, void *user_data)
+{
+	ail_request_h req = user_data;
+	ail_appinfo_h ai;
+
+	if (_is_cancelled(req))
+		return AIL_CB_RET_CANCEL;
+
+	ai = appinfo_detach(appinfo);
+	if (!ai)
+		return AIL_CB_RET_CANCEL;
+
+	g_ptr_array_add(req->pending, ai);
+	if (req->pending->len >= req->batch_size) {
+		_post(req, AIL_ERROR_OK, req->pending, false);
+		req->pending = g_ptr_array_new();
+	}
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+static void _work(gpointer data, gpointer user_data)
+{
+	ail_request_h req = data;
+	GPtrArray *appinfos;
+	ail_appinfo_h ai = NULL;
+	ail_error_e ret;
+
+	if (_is_cancelled(req)) {
+		_unref(req);
+		return;
+	}
+
+	if (ASYNC_GET_APPINFO == req->type) {
+		appinfos = g_ptr_array_new();
+		ret = ail_get_appinfo(req->appid, &ai);
+		if (ret == AIL_ERROR_OK)
+			g_ptr_array_add(appinfos, ai);
+	} else {
+		req->pending = g_ptr_array_new();
+		ret = ail_filter_list_appinfo_foreach(req->filter, _collect, req);
+		appinfos = req->pending;
+		req->pending = NULL;
+	}
+
+	_post(req, ret, appinfos, true);
+	_unref(req);
+}
+
+
+
+static ail_error_e _submit(ail_request_h req, ail_request_h *request)
+{
+	GError *error = NULL;
+
+	pthread_mutex_lock(&pool_lock);
+	/* Exclusive, its threads and their connections live as long as the process */
+	if (!pool)
+		pool = g_thread_pool_new(_work, NULL, ASYNC_THREADS, TRUE, &error);
+	pthread_mutex_unlock(&pool_lock);
+
+	if (!pool) {
+		_E("Cannot start the workers: %s", error ? error->message : "");
+		if (error)
+			g_error_free(error);
+		return AIL_ERROR_FAIL;
+	}
+
+	/* One reference for the user, one for the worker */
+	req->ref = 2;
+	*request = req;
+
+	if (!g_thread_pool_push(pool, req, &error)) {
+		_E("Cannot queue the request: %s", error ? error->message : "");
+		if (error)
+			g_error_free(error);
+		*request = NULL;
+		req->ref = 1;
+		return AIL_ERROR_FAIL;
+	}
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static ail_request_h _new_request(async_type type, GMainContext *context, void *user_data)
+{
+	ail_request_h req;
+
+	req = calloc(1, sizeof(struct ail_request));
+	retv_if(!req, NULL);
+
+	req->ref = 1;
+	req->type = type;
+	req->context = g_main_context_ref(context ? context : g_main_context_default());
+	req->user_data = user_data;
+
+	return req;
+}
+
+
+
+EXPORT_API ail_error_e ail_get_appinfo_async(const char *appid, GMainContext *context,
+		ail_get_appinfo_cb cb, void *user_data, ail_request_h *request)
+{
+	ail_request_h req;
+	ail_error_e ret;
+
+	retv_if(!appid, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!request, AIL_ERROR_INVALID_PARAMETER);
+
+	req = _new_request(ASYNC_GET_APPINFO, context, user_data);
+	retv_if(!req, AIL_ERROR_OUT_OF_MEMORY);
+
+	req->get_cb = cb;
+	req->appid = strdup(appid);
+	if (!req->appid) {
+		_unref(req);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	ret = _submit(req, request);
+	if (ret != AIL_ERROR_OK)
+		_unref(req);
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_filter_list_appinfo_async(ail_filter_h filter, int batch_size,
+		GMainContext *context, ail_list_appinfo_batch_cb cb, void *user_data,
+		ail_request_h *request)
+{
+	ail_request_h req;
+	ail_error_e ret;
+
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!request, AIL_ERROR_INVALID_PARAMETER);
+
+	req = _new_request(ASYNC_LIST_APPINFO, context, user_data);
+	retv_if(!req, AIL_ERROR_OUT_OF_MEMORY);
+
+	req->list_cb = cb;
+	req->batch_size = (batch_size > 0) ? batch_size : ASYNC_BATCH_DEFAULT;
+	if (filter) {
+		/* The caller may destroy its filter right away */
+		req->filter = filter_dup(filter);
+		if (!req->filter) {
+			_unref(req);
+			return AIL_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	ret = _submit(req, request);
+	if (ret != AIL_ERROR_OK)
+		_unref(req);
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_request_cancel(ail_request_h request)
+{
+	retv_if(!request, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(_is_cancelled(request), AIL_ERROR_INVALID_PARAMETER);
+
+	__atomic_store_n(&request->cancelled, 1, __ATOMIC_RELEASE);
+	_unref(request);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+// End of file
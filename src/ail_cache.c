@@ -0,0 +1,600 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <glib.h>
+#include <vconf.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_cache.h"
+#include "ail_db.h"
+
+#define BLOOM_HASHES		7
+#define BLOOM_BITS_PER_KEY	10
+#define BLOOM_BITS_MIN		1024
+#define ABSENT_MAX		256
+
+struct cache_entry {
+	char **values;
+	GList *link;
+};
+
+static struct {
+	pthread_mutex_t lock;
+	int size;
+	GHashTable *by_appid;
+	GHashTable *by_package;
+	GQueue lru;
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+	unsigned long invalidations;
+	/* Existence filter over every appid and package, NULL until built */
+	guint32 *bloom;
+	guint32 bloom_mask;
+	/* "<type>:<key>" looked up and not registered */
+	GHashTable *absent;
+	unsigned long absent_hits;
+	/* DB generation the content was read at */
+	unsigned long long generation;
+} cache = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.size = 0,
+	.by_appid = NULL,
+	.by_package = NULL,
+};
+
+
+
+static char **_dup_values(char **values)
+{
+	char **dup;
+	int i;
+
+	dup = calloc(NUM_OF_PROP, sizeof(char *));
+	retv_if(!dup, NULL);
+
+	for (i = 0; i < NUM_OF_PROP; i++) {
+		if (!values[i])
+			continue;
+
+		dup[i] = strdup(values[i]);
+		if (!dup[i]) {
+			while (--i >= 0)
+				SAFE_FREE(dup[i]);
+			free(dup);
+			return NULL;
+		}
+	}
+
+	return dup;
+}
+
+
+
+static void _free_values(char **values)
+{
+	int i;
+
+	if (!values)
+		return;
+
+	for (i = 0; i < NUM_OF_PROP; i++)
+		SAFE_FREE(values[i]);
+	free(values);
+}
+
+
+
+/* Must be called with cache.lock held */
+static void _remove_entry(struct cache_entry *e)
+{
+	char *appid = e->values[E_AIL_PROP_X_SLP_APPID_STR];
+	char *package = e->values[E_AIL_PROP_PACKAGE_STR];
+
+	if (appid && g_hash_table_lookup(cache.by_appid, appid) == e)
+		g_hash_table_remove(cache.by_appid, appid);
+	if (package && g_hash_table_lookup(cache.by_package, package) == e)
+		g_hash_table_remove(cache.by_package, package);
+
+	g_queue_delete_link(&cache.lru, e->link);
+	_free_values(e->values);
+	free(e);
+}
+
+
+
+static void _bloom_hash(cache_key_type type, const char *key, guint32 *h1, guint32 *h2)
+{
+	const unsigned char *p;
+	guint32 h = 2166136261u ^ (guint32)type;
+
+	/* FNV-1a, and a remix of it as the step of double hashing */
+	for (p = (const unsigned char *)key; *p; p++) {
+		h ^= *p;
+		h *= 16777619u;
+	}
+
+	*h1 = h;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	*h2 = h | 1;
+}
+
+
+
+static void _bloom_add(guint32 *bloom, guint32 mask, cache_key_type type, const char *key)
+{
+	guint32 h1, h2, b;
+	int i;
+
+	_bloom_hash(type, key, &h1, &h2);
+	for (i = 0; i < BLOOM_HASHES; i++) {
+		b = (h1 + i * h2) & mask;
+		bloom[b >> 5] |= 1u << (b & 31);
+	}
+}
+
+
+
+/* Must be called with cache.lock held */
+static bool _bloom_test(cache_key_type type, const char *key)
+{
+	guint32 h1, h2, b;
+	int i;
+
+	_bloom_hash(type, key, &h1, &h2);
+	for (i = 0; i < BLOOM_HASHES; i++) {
+		b = (h1 + i * h2) & cache.bloom_mask;
+		if (!(cache.bloom[b >> 5] & (1u << (b & 31))))
+			return false;
+	}
+
+	return true;
+}
+
+
+
+/* Called without cache.lock, the scans may wait for a connection. NULL unless every row was read */
+static guint32 *_bloom_build(guint32 *mask)
+{
+	sqlite3_stmt *stmt;
+	char *package, *appid;
+	guint32 *bloom;
+	guint32 bits;
+	int n = 0;
+	ail_error_e ret;
+
+	if (db_open(DB_OPEN_RO) != AIL_ERROR_OK)
+		return NULL;
+
+	if (db_prepare("SELECT COUNT(*) FROM app_info;", &stmt) != AIL_ERROR_OK)
+		return NULL;
+	if (db_step(stmt) == AIL_ERROR_OK)
+		db_column_int(stmt, 0, &n);
+	db_finalize(stmt);
+
+	/* Two keys per row, about 1% false positives */
+	for (bits = BLOOM_BITS_MIN; bits < (guint32)n * 2 * BLOOM_BITS_PER_KEY; bits <<= 1)
+		;
+
+	if (db_prepare("SELECT package, x_slp_appid FROM app_info;", &stmt) != AIL_ERROR_OK)
+		return NULL;
+
+	bloom = calloc(bits / 32, sizeof(guint32));
+	if (!bloom) {
+		db_finalize(stmt);
+		return NULL;
+	}
+
+	while ((ret = db_step(stmt)) == AIL_ERROR_OK) {
+		db_column_str(stmt, 0, &package);
+		db_column_str(stmt, 1, &appid);
+		if (package)
+			_bloom_add(bloom, bits - 1, CACHE_KEY_PACKAGE, package);
+		if (appid)
+			_bloom_add(bloom, bits - 1, CACHE_KEY_APPID, appid);
+	}
+
+	db_finalize(stmt);
+
+	/* A partial filter would call registered appids absent */
+	if (ret != AIL_ERROR_NO_DATA) {
+		_E("Cannot read every row for the existence filter");
+		free(bloom);
+		return NULL;
+	}
+
+	*mask = bits - 1;
+	_D("Existence filter : %d rows, %u bits", n, bits);
+
+	return bloom;
+}
+
+
+
+/* Must be called with cache.lock held */
+static void _forget_existence(void)
+{
+	SAFE_FREE(cache.bloom);
+	cache.bloom = NULL;
+	if (cache.absent)
+		g_hash_table_remove_all(cache.absent);
+}
+
+
+
+/* Must be called with cache.lock held */
+static void _clear(void)
+{
+	struct cache_entry *e;
+
+	while ((e = g_queue_peek_head(&cache.lru)))
+		_remove_entry(e);
+}
+
+
+
+/* Must be called with cache.lock held */
+static void _invalidate_package(const char *package)
+{
+	struct cache_entry *e;
+
+	if (!cache.by_package)
+		return;
+
+	/* Any change may register an appid or a package */
+	_forget_existence();
+
+	e = g_hash_table_lookup(cache.by_package, package);
+	if (!e)
+		return;
+
+	_remove_entry(e);
+	cache.invalidations++;
+	_D("Invalidate (%s).", package);
+}
+
+
+
+static void _noti_cb(keynode_t *node, void *user_data)
+{
+	char *noti;
+	char *package;
+
+	noti = vconf_keynode_get_str(node);
+	if (!noti)
+		return;
+
+	/* "create:<package>", "update:<package>" or "delete:<package>" */
+	package = strchr(noti, ':');
+	if (!package || !strncmp(noti, "batch:", 6)) {
+		pthread_mutex_lock(&cache.lock);
+		_clear();
+		_forget_existence();
+		pthread_mutex_unlock(&cache.lock);
+		return;
+	}
+
+	cache_invalidate_package(package + 1);
+}
+
+
+
+/* Must be called with cache.lock held */
+static void _validate(void)
+{
+	unsigned long long generation;
+
+	/* Catches writes of other processes without waiting for the noti */
+	if (!db_read_generation(&generation) || generation == cache.generation)
+		return;
+
+	cache.invalidations += cache.lru.length;
+	_clear();
+	_forget_existence();
+	cache.generation = generation;
+}
+
+
+
+/* Entries hold the name for the locale they were read with */
+static void _lang_cb(keynode_t *node, void *user_data)
+{
+	pthread_mutex_lock(&cache.lock);
+	cache.invalidations += cache.lru.length;
+	_clear();
+	pthread_mutex_unlock(&cache.lock);
+}
+
+
+
+ail_error_e cache_lookup(cache_key_type type, const char *key, char ***values)
+{
+	struct cache_entry *e;
+	GHashTable *table;
+
+	retv_if(!key, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!values, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&cache.lock);
+
+	if (!cache.size) {
+		pthread_mutex_unlock(&cache.lock);
+		return AIL_ERROR_NO_DATA;
+	}
+
+	_validate();
+
+	table = (CACHE_KEY_APPID == type) ? cache.by_appid : cache.by_package;
+	e = g_hash_table_lookup(table, key);
+	if (!e) {
+		cache.misses++;
+		pthread_mutex_unlock(&cache.lock);
+		return AIL_ERROR_NO_DATA;
+	}
+
+	*values = _dup_values(e->values);
+	if (!*values) {
+		pthread_mutex_unlock(&cache.lock);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	g_queue_unlink(&cache.lru, e->link);
+	g_queue_push_head_link(&cache.lru, e->link);
+	cache.hits++;
+
+	pthread_mutex_unlock(&cache.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+void cache_store(char **values)
+{
+	struct cache_entry *e, *old;
+	char *appid, *package;
+
+	if (!values)
+		return;
+
+	pthread_mutex_lock(&cache.lock);
+
+	if (!cache.size) {
+		pthread_mutex_unlock(&cache.lock);
+		return;
+	}
+
+	e = calloc(1, sizeof(struct cache_entry));
+	if (!e) {
+		pthread_mutex_unlock(&cache.lock);
+		return;
+	}
+
+	e->values = _dup_values(values);
+	if (!e->values) {
+		free(e);
+		pthread_mutex_unlock(&cache.lock);
+		return;
+	}
+
+	appid = e->values[E_AIL_PROP_X_SLP_APPID_STR];
+	package = e->values[E_AIL_PROP_PACKAGE_STR];
+
+	if (appid && (old = g_hash_table_lookup(cache.by_appid, appid)))
+		_remove_entry(old);
+	if (package && (old = g_hash_table_lookup(cache.by_package, package)))
+		_remove_entry(old);
+
+	while (cache.lru.length >= cache.size) {
+		_remove_entry(g_queue_peek_tail(&cache.lru));
+		cache.evictions++;
+	}
+
+	g_queue_push_head(&cache.lru, e);
+	e->link = g_queue_peek_head_link(&cache.lru);
+
+	if (appid)
+		g_hash_table_insert(cache.by_appid, appid, e);
+	if (package)
+		g_hash_table_insert(cache.by_package, package, e);
+
+	pthread_mutex_unlock(&cache.lock);
+}
+
+
+
+bool cache_is_absent(cache_key_type type, const char *key)
+{
+	unsigned long long generation;
+	guint32 *bloom;
+	guint32 mask = 0;
+	char *k;
+	bool absent = false;
+
+	retv_if(!key, false);
+
+	pthread_mutex_lock(&cache.lock);
+
+	if (!cache.size) {
+		pthread_mutex_unlock(&cache.lock);
+		return false;
+	}
+
+	_validate();
+
+	if (!cache.bloom) {
+		generation = cache.generation;
+		pthread_mutex_unlock(&cache.lock);
+		bloom = _bloom_build(&mask);
+		pthread_mutex_lock(&cache.lock);
+
+		if (!cache.size) {
+			pthread_mutex_unlock(&cache.lock);
+			free(bloom);
+			return false;
+		}
+
+		/* Kept only if nothing changed while it was built */
+		_validate();
+		if (bloom && !cache.bloom && cache.generation == generation) {
+			cache.bloom = bloom;
+			cache.bloom_mask = mask;
+		} else
+			free(bloom);
+	}
+
+	if (cache.bloom && !_bloom_test(type, key))
+		absent = true;
+	else {
+		k = g_strdup_printf("%d:%s", type, key);
+		if (k) {
+			absent = g_hash_table_lookup(cache.absent, k) != NULL;
+			g_free(k);
+		}
+	}
+
+	if (absent)
+		cache.absent_hits++;
+
+	pthread_mutex_unlock(&cache.lock);
+
+	return absent;
+}
+
+
+
+void cache_store_absent(cache_key_type type, const char *key)
+{
+	char *k;
+
+	if (!key)
+		return;
+
+	pthread_mutex_lock(&cache.lock);
+
+	if (cache.size) {
+		k = g_strdup_printf("%d:%s", type, key);
+		if (k) {
+			if (g_hash_table_size(cache.absent) >= ABSENT_MAX)
+				g_hash_table_remove_all(cache.absent);
+			g_hash_table_replace(cache.absent, k, k);
+		}
+	}
+
+	pthread_mutex_unlock(&cache.lock);
+}
+
+
+
+void cache_invalidate_package(const char *package)
+{
+	if (!package)
+		return;
+
+	pthread_mutex_lock(&cache.lock);
+	_invalidate_package(package);
+	pthread_mutex_unlock(&cache.lock);
+}
+
+
+
+EXPORT_API ail_error_e ail_cache_enable(int size)
+{
+	retv_if(size <= 0, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&cache.lock);
+
+	if (!cache.by_appid) {
+		cache.by_appid = g_hash_table_new(g_str_hash, g_str_equal);
+		cache.by_package = g_hash_table_new(g_str_hash, g_str_equal);
+		cache.absent = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+		g_queue_init(&cache.lru);
+	}
+
+	if (!cache.size) {
+		if (vconf_notify_key_changed(AIL_NOTI_KEY, _noti_cb, NULL) < 0)
+			_E("Cannot watch %s, only local changes invalidate the cache", AIL_NOTI_KEY);
+		if (vconf_notify_key_changed(VCONFKEY_LANGSET, _lang_cb, NULL) < 0)
+			_E("Cannot watch %s, names may not follow the language", VCONFKEY_LANGSET);
+	}
+
+	cache.size = size;
+	while (cache.lru.length > cache.size) {
+		_remove_entry(g_queue_peek_tail(&cache.lru));
+		cache.evictions++;
+	}
+
+	pthread_mutex_unlock(&cache.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_cache_disable(void)
+{
+	pthread_mutex_lock(&cache.lock);
+
+	if (cache.size) {
+		vconf_ignore_key_changed(AIL_NOTI_KEY, _noti_cb);
+		vconf_ignore_key_changed(VCONFKEY_LANGSET, _lang_cb);
+		_clear();
+		_forget_existence();
+		cache.size = 0;
+	}
+
+	pthread_mutex_unlock(&cache.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_cache_get_stats(ail_cache_stats_s *stats)
+{
+	retv_if(!stats, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&cache.lock);
+
+	stats->size = cache.size;
+	stats->entries = cache.lru.length;
+	stats->hits = cache.hits;
+	stats->misses = cache.misses;
+	stats->evictions = cache.evictions;
+	stats->invalidations = cache.invalidations;
+	stats->absent_hits = cache.absent_hits;
+
+	pthread_mutex_unlock(&cache.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+// End of file
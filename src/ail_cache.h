@@ -0,0 +1,41 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#ifndef __AIL_CACHE_H__
+#define __AIL_CACHE_H__
+
+#include "ail.h"
+
+typedef enum {
+	CACHE_KEY_APPID,
+	CACHE_KEY_PACKAGE,
+} cache_key_type;
+
+ail_error_e cache_lookup(cache_key_type type, const char *key, char ***values);
+void cache_store(char **values);
+bool cache_is_absent(cache_key_type type, const char *key);
+void cache_store_absent(cache_key_type type, const char *key);
+void cache_invalidate_package(const char *package);
+
+#endif  /* __AIL_CACHE_H__ */
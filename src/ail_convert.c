@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 #include "ail.h"
 #include "ail_private.h"
 #include "ail_convert.h"
@@ -80,53 +81,160 @@ static struct _ail_bool_map_t bool_prop_map[] = {
 };
 
 
+#define PROP_HASH_SIZE	128
+
+/* Compile-time check that the public property IDs are the internal ones */
+#define PROP_ID_CHECK(id, prop) typedef char prop##_matches_id[((int)(id) == (int)(prop)) ? 1 : -1]
+
+PROP_ID_CHECK(AIL_PROP_ID_PACKAGE_STR, E_AIL_PROP_PACKAGE_STR);
+PROP_ID_CHECK(AIL_PROP_ID_EXEC_STR, E_AIL_PROP_EXEC_STR);
+PROP_ID_CHECK(AIL_PROP_ID_NAME_STR, E_AIL_PROP_NAME_STR);
+PROP_ID_CHECK(AIL_PROP_ID_TYPE_STR, E_AIL_PROP_TYPE_STR);
+PROP_ID_CHECK(AIL_PROP_ID_ICON_STR, E_AIL_PROP_ICON_STR);
+PROP_ID_CHECK(AIL_PROP_ID_CATEGORIES_STR, E_AIL_PROP_CATEGORIES_STR);
+PROP_ID_CHECK(AIL_PROP_ID_VERSION_STR, E_AIL_PROP_VERSION_STR);
+PROP_ID_CHECK(AIL_PROP_ID_MIMETYPE_STR, E_AIL_PROP_MIMETYPE_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_SERVICE_STR, E_AIL_PROP_X_SLP_SERVICE_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_PACKAGETYPE_STR, E_AIL_PROP_X_SLP_PACKAGETYPE_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_PACKAGECATEGORIES_STR, E_AIL_PROP_X_SLP_PACKAGECATEGORIES_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_PACKAGEID_STR, E_AIL_PROP_X_SLP_PACKAGEID_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_SVC_STR, E_AIL_PROP_X_SLP_SVC_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_EXE_PATH, E_AIL_PROP_X_SLP_EXE_PATH);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_APPID_STR, E_AIL_PROP_X_SLP_APPID_STR);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_TEMP_INT, E_AIL_PROP_X_SLP_TEMP_INT);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_INSTALLEDTIME_INT, E_AIL_PROP_X_SLP_INSTALLEDTIME_INT);
+PROP_ID_CHECK(AIL_PROP_ID_NODISPLAY_BOOL, E_AIL_PROP_NODISPLAY_BOOL);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_TASKMANAGE_BOOL, E_AIL_PROP_X_SLP_TASKMANAGE_BOOL);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_MULTIPLE_BOOL, E_AIL_PROP_X_SLP_MULTIPLE_BOOL);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_REMOVABLE_BOOL, E_AIL_PROP_X_SLP_REMOVABLE_BOOL);
+PROP_ID_CHECK(AIL_PROP_ID_X_SLP_INACTIVATED_BOOL, E_AIL_PROP_X_SLP_INACTIVATED_BOOL);
+
+struct _ail_hash_entry_t {
+	const char *property;
+	int prop;
+};
+
+static struct _ail_hash_entry_t prop_hash[PROP_HASH_SIZE];
+static unsigned int prop_hash_seed;
+static pthread_once_t prop_hash_once = PTHREAD_ONCE_INIT;
+
+
+
+static inline unsigned int _hash(const char *str, unsigned int seed)
+{
+	unsigned int h = 2166136261u ^ seed;
+
+	while (*str) {
+		h ^= (unsigned char)*str++;
+		h *= 16777619u;
+	}
+
+	return h & (PROP_HASH_SIZE - 1);
+}
+
+
+
+static int _add_to_hash(const char *property, int prop, unsigned int seed)
+{
+	struct _ail_hash_entry_t *e;
+
+	e = &prop_hash[_hash(property, seed)];
+	if (e->property)
+		return -1;
+
+	e->property = property;
+	e->prop = prop;
+
+	return 0;
+}
+
+
+
+static int _try_seed(unsigned int seed)
+{
+	int i;
+
+	memset(prop_hash, 0, sizeof(prop_hash));
+
+	for (i = 0; i < sizeof(str_prop_map) / sizeof(str_prop_map[0]); i++)
+		if (_add_to_hash(str_prop_map[i].property, str_prop_map[i].prop, seed) < 0)
+			return -1;
+	for (i = 0; i < sizeof(int_prop_map) / sizeof(int_prop_map[0]); i++)
+		if (_add_to_hash(int_prop_map[i].property, int_prop_map[i].prop, seed) < 0)
+			return -1;
+	for (i = 0; i < sizeof(bool_prop_map) / sizeof(bool_prop_map[0]); i++)
+		if (_add_to_hash(bool_prop_map[i].property, bool_prop_map[i].prop, seed) < 0)
+			return -1;
+
+	return 0;
+}
+
+
+
+/* Search a seed which gives every property its own slot */
+static void _build_prop_hash(void)
+{
+	unsigned int seed;
+
+	for (seed = 0; _try_seed(seed) < 0; seed++)
+		;
+
+	prop_hash_seed = seed;
+	_D("Property hash seed = %u", seed);
+}
+
+
+
+static inline int _ail_convert_to_prop(const char *property)
+{
+	struct _ail_hash_entry_t *e;
+
+	pthread_once(&prop_hash_once, _build_prop_hash);
+
+	e = &prop_hash[_hash(property, prop_hash_seed)];
+	if (!e->property || strcmp(e->property, property))
+		return -1;
+
+	return e->prop;
+}
+
+
+
 inline ail_prop_str_e _ail_convert_to_prop_str(const char *property)
 {
-	int i = 0;
-	ail_prop_str_e prop = -1;
+	int prop;
 
 	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
 
-	for (i=0 ; i<(E_AIL_PROP_STR_MAX - E_AIL_PROP_STR_MIN + 1) ; i++) {
-		if (strcmp(property, str_prop_map[i].property) == 0) {
-			prop =	str_prop_map[i].prop;
-			break;
-		}
-	}
+	prop = _ail_convert_to_prop(property);
+	if (prop < E_AIL_PROP_STR_MIN || prop > E_AIL_PROP_STR_MAX)
+		return -1;
 
 	return prop;
 }
 
 inline ail_prop_int_e _ail_convert_to_prop_int(const char *property)
 {
-	int i = 0;
-	ail_prop_int_e prop = -1;
+	int prop;
 
 	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
 
-	for (i=0 ; i<(E_AIL_PROP_INT_MAX - E_AIL_PROP_INT_MIN + 1) ; i++) {
-		if (strcmp(property, int_prop_map[i].property) == 0) {
-			prop =	int_prop_map[i].prop;
-			break;
-		}
-	}
+	prop = _ail_convert_to_prop(property);
+	if (prop < E_AIL_PROP_INT_MIN || prop > E_AIL_PROP_INT_MAX)
+		return -1;
 
 	return prop;
 }
 
 inline ail_prop_bool_e _ail_convert_to_prop_bool(const char *property)
 {
-	int i = 0;
-	ail_prop_bool_e prop = -1;
+	int prop;
 
 	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
 
-	for (i=0 ; i<(E_AIL_PROP_BOOL_MAX - E_AIL_PROP_BOOL_MIN + 1) ; i++) {
-		if (strcmp(property, bool_prop_map[i].property) == 0) {
-			prop = 	bool_prop_map[i].prop;
-			break;
-		}
-	}
+	prop = _ail_convert_to_prop(property);
+	if (prop < E_AIL_PROP_BOOL_MIN || prop > E_AIL_PROP_BOOL_MAX)
+		return -1;
 
 	return prop;
 }
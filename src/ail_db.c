@@ -22,12 +22,26 @@
 
 
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <db-util.h>
 #include <glib.h>
 #include "ail_private.h"
 #include "ail_db.h"
+#include "ail_sql.h"
+#include "ail_stats.h"
+#include "ail_trace.h"
+#include "ail_record.h"
+#include "ail_icon.h"
 
 #define retv_with_dbmsg_if(expr, val) do { \
 	if (expr) { \
@@ -38,33 +52,763 @@
 } while (0)
 
 
+#define CONTEXT_CONNECTIONS_DEFAULT	4
+#define CONTEXT_IDLE_TIMEOUT_DEFAULT	30
+/* Milliseconds a read waits for a free connection before it fails */
+#define CONTEXT_WAIT_MS_DEFAULT		5000
+
+struct pooled {
+	sqlite3 *db;
+	time_t since;
+	int tuned;		/* version of the tuning applied to db */
+};
+
+struct ail_context {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	int max;
+	int idle_timeout;
+	int wait_ms;
+	int open;		/* idle and leased */
+	int n_idle;
+	struct pooled *idle;	/* least recently used first */
+};
+
+static struct ail_context default_context = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+	.max = CONTEXT_CONNECTIONS_DEFAULT,
+	.idle_timeout = CONTEXT_IDLE_TIMEOUT_DEFAULT,
+	.wait_ms = CONTEXT_WAIT_MS_DEFAULT,
+};
+
+static __thread struct ail_context *thread_context;
+
+/* dbro is leased from a context from the first db_prepare() to the last db_finalize() */
 static __thread struct {
         sqlite3         *dbro;
         sqlite3         *dbrw;
+	struct ail_context *context;
+	int leases;
+	int dbro_tuned;
+	int dbrw_tuned;
 } db_info = {
         .dbro = NULL,
-	.dbrw = NULL
+	.dbrw = NULL,
+	.context = NULL,
+	.leases = 0,
+	.dbro_tuned = 0,
+	.dbrw_tuned = 0,
 };
 
-ail_error_e db_open(db_open_mode mode)
+/* Pragmas applied to every connection, a connection catches up with version when it is next used */
+static struct {
+	pthread_mutex_t lock;
+	bool loaded;
+	int version;
+	ail_db_config_s config;
+} tuning = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.loaded = false,
+	.version = 1,
+};
+
+static ail_error_e _fill_tokens(void);
+static ail_error_e _fill_exe_paths(void);
+static ail_error_e _fill_icon_names(void);
+static ail_error_e _fill_name_index(void);
+
+/* app_name_fts, kept up to date by triggers */
+static const char name_index[] =
+	"CREATE VIRTUAL TABLE app_name_fts USING fts4(name, package, locale);"
+	"INSERT INTO app_name_fts (name, package, locale) "
+		"SELECT name, package, '' FROM app_info;"
+	"INSERT INTO app_name_fts (name, package, locale) "
+		"SELECT name, package, locale FROM localname;"
+	"CREATE TRIGGER app_info_fts_insert AFTER INSERT ON app_info BEGIN "
+		"INSERT INTO app_name_fts (name, package, locale) "
+		"VALUES (new.name, new.package, ''); END;"
+	"CREATE TRIGGER app_info_fts_update AFTER UPDATE OF name ON app_info BEGIN "
+		"UPDATE app_name_fts SET name = new.name "
+		"WHERE package = old.package AND locale = ''; END;"
+	"CREATE TRIGGER app_info_fts_delete AFTER DELETE ON app_info BEGIN "
+		"DELETE FROM app_name_fts WHERE package = old.package AND locale = ''; END;"
+	"CREATE TRIGGER localname_fts_insert AFTER INSERT ON localname BEGIN "
+		"INSERT INTO app_name_fts (name, package, locale) "
+		"VALUES (new.name, new.package, new.locale); END;"
+	"CREATE TRIGGER localname_fts_update AFTER UPDATE OF name ON localname BEGIN "
+		"UPDATE app_name_fts SET name = new.name "
+		"WHERE package = old.package AND locale = old.locale; END;"
+	"CREATE TRIGGER localname_fts_delete AFTER DELETE ON localname BEGIN "
+		"DELETE FROM app_name_fts WHERE package = old.package AND locale = old.locale; END;";
+
+/* upgrades[v] brings a database from user_version v to v + 1 */
+static const struct {
+	const char *sql;
+	ail_error_e (*fill)(void);	/* moves existing data, run after sql, or what sql cannot do alone */
+} upgrades[DB_SCHEMA_VERSION] = {
+	/* 1 : indexes for the lookup and list access paths.
+	 * app_info_visible covers the COUNT of visible apps; the list of visible
+	 * apps walks it in package order, so it needs no sort, but reads each row
+	 * from app_info since covering all the columns would copy the table. */
+	{ "CREATE INDEX IF NOT EXISTS app_info_appid ON app_info (x_slp_appid);"
+	"CREATE INDEX IF NOT EXISTS app_info_exec ON app_info (exec);"
+	"CREATE INDEX IF NOT EXISTS app_info_exe_path ON app_info (x_slp_exe_path);"
+	"CREATE INDEX IF NOT EXISTS app_info_packageid ON app_info (x_slp_packageid);"
+	"CREATE INDEX IF NOT EXISTS app_info_visible ON app_info (nodisplay, package);", NULL },
+	/* 2 : full-text index of the default ('' locale) and localized names, if SQLite has FTS4 */
+	{ NULL, _fill_name_index },
+	/* 3 : one row per entry of the ';'-separated list columns */
+	{ "CREATE TABLE app_token (package TEXT NOT NULL, "
+		"field TEXT NOT NULL, "
+		"value TEXT NOT NULL COLLATE NOCASE, "
+		"PRIMARY KEY (field, value, package));"
+	"CREATE INDEX app_token_package ON app_token (package);", _fill_tokens },
+	/* 4 : exe_path entries, declared and with symlinks resolved */
+	{ "DELETE FROM app_token WHERE field='exe_path';", _fill_exe_paths },
+	/* 5 : generation of the last committed change */
+	{ "CREATE TABLE generation (value INTEGER NOT NULL);"
+	"INSERT INTO generation (value) VALUES (0);", NULL },
+	/* 6 : journal of committed changes, seq never reused */
+	{ "CREATE TABLE change_log (seq INTEGER PRIMARY KEY AUTOINCREMENT, "
+		"type INTEGER NOT NULL, "
+		"package TEXT NOT NULL);", NULL },
+	/* 7 : icon names instead of paths resolved for the theme of the install */
+	{ NULL, _fill_icon_names },
+	/* 8 : case-sensitive tokens for exe_path, the list fields compare with NOCASE */
+	{ "ALTER TABLE app_token RENAME TO app_token_old;"
+	"CREATE TABLE app_token (package TEXT NOT NULL, "
+		"field TEXT NOT NULL, "
+		"value TEXT NOT NULL, "
+		"PRIMARY KEY (field, value, package));"
+	"INSERT INTO app_token SELECT package, field, value FROM app_token_old;"
+	"DROP TABLE app_token_old;"
+	"CREATE INDEX app_token_package ON app_token (package);"
+	"CREATE INDEX app_token_nocase ON app_token (field, value COLLATE NOCASE, package);", NULL },
+};
+
+/* Entries kept in change_log, older ones need a full listing */
+#define CHANGE_LOG_MAX	4096
+
+/* APP_INFO_GENERATION mapped once per process, shared by its threads */
+static struct {
+	pthread_mutex_t lock;
+	unsigned long long *ro;
+	unsigned long long *rw;
+	time_t ro_failed;	/* last failed attempt, retried a second later */
+} generation = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.ro = NULL,
+	.rw = NULL,
+	.ro_failed = 0,
+};
+
+
+
+static int _get_int(sqlite3 *db, const char *query)
+{
+	sqlite3_stmt *stmt;
+	int value = -1;
+
+	if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) != SQLITE_OK)
+		return -1;
+
+	if (sqlite3_step(stmt) == SQLITE_ROW)
+		value = sqlite3_column_int(stmt, 0);
+	else
+		value = 0;
+
+	sqlite3_finalize(stmt);
+
+	return value;
+}
+
+
+
+static sqlite3_stmt *_prepare_token_insert(void)
+{
+	sqlite3_stmt *stmt;
+
+	if (sqlite3_prepare_v2(db_info.dbrw, "INSERT OR IGNORE INTO app_token "
+				"(package, field, value) VALUES (?, ?, ?);",
+				-1, &stmt, NULL) != SQLITE_OK) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		return NULL;
+	}
+
+	return stmt;
+}
+
+
+
+static ail_error_e _insert_token(sqlite3_stmt *stmt, const char *package, const char *field, const char *value)
+{
+	ail_error_e ret = AIL_ERROR_OK;
+
+	sqlite3_bind_text(stmt, 1, package, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 2, field, -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 3, value, -1, SQLITE_STATIC);
+	if (sqlite3_step(stmt) != SQLITE_DONE) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		ret = AIL_ERROR_DB_FAILED;
+	}
+	sqlite3_reset(stmt);
+
+	return ret;
+}
+
+
+
+ail_error_e db_insert_tokens(const char *package, int prop, const char *value)
+{
+	sqlite3_stmt *stmt;
+	const char *field;
+	char *list, *token, *save_ptr;
+	ail_error_e ret = AIL_ERROR_OK;
+
+	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
+
+	field = sql_get_list_field(prop);
+	retv_if(!field, AIL_ERROR_INVALID_PARAMETER);
+
+	if (!value)
+		return AIL_ERROR_OK;
+
+	list = strdup(value);
+	retv_if(!list, AIL_ERROR_OUT_OF_MEMORY);
+
+	stmt = _prepare_token_insert();
+	if (!stmt) {
+		free(list);
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	for (token = strtok_r(list, ";", &save_ptr); token && ret == AIL_ERROR_OK;
+			token = strtok_r(NULL, ";", &save_ptr)) {
+		token = g_strstrip(token);
+		if (*token)
+			ret = _insert_token(stmt, package, field, token);
+	}
+
+	sqlite3_finalize(stmt);
+	free(list);
+
+	return ret;
+}
+
+
+
+ail_error_e db_insert_exe_path(const char *package, const char *path)
+{
+	sqlite3_stmt *stmt;
+	char *canonical;
+	ail_error_e ret;
+
+	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
+
+	if (!path || !*path)
+		return AIL_ERROR_OK;
+
+	stmt = _prepare_token_insert();
+	retv_if(!stmt, AIL_ERROR_DB_FAILED);
+
+	ret = _insert_token(stmt, package, SQL_FIELD_EXE_PATH, path);
+
+	/* /proc/<pid>/exe shows the target, not the link the desktop file names */
+	canonical = realpath(path, NULL);
+	if (canonical) {
+		if (ret == AIL_ERROR_OK && strcmp(canonical, path))
+			ret = _insert_token(stmt, package, SQL_FIELD_EXE_PATH, canonical);
+		free(canonical);
+	}
+
+	sqlite3_finalize(stmt);
+
+	return ret;
+}
+
+
+
+static ail_error_e _fill_exe_paths(void)
+{
+	sqlite3_stmt *stmt;
+	ail_error_e ret = AIL_ERROR_OK;
+
+	if (sqlite3_prepare_v2(db_info.dbrw, "SELECT package, x_slp_exe_path FROM app_info;",
+				-1, &stmt, NULL) != SQLITE_OK) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	while (ret == AIL_ERROR_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+		ret = db_insert_exe_path((const char *)sqlite3_column_text(stmt, 0),
+				(const char *)sqlite3_column_text(stmt, 1));
+	}
+
+	sqlite3_finalize(stmt);
+
+	return ret;
+}
+
+
+
+static ail_error_e _fill_name_index(void)
+{
+	char *errmsg = NULL;
+
+	/* Without it writes must go on, searches fall back to LIKE */
+	if (sqlite3_exec(db_info.dbrw, "CREATE VIRTUAL TABLE temp.fts_probe USING fts4(x);"
+				"DROP TABLE temp.fts_probe;", NULL, NULL, &errmsg) != SQLITE_OK) {
+		_E("No name index, SQLite has no FTS4: %s", errmsg);
+		sqlite3_free(errmsg);
+		return AIL_ERROR_OK;
+	}
+
+	return db_exec(name_index);
+}
+
+
+
+static ail_error_e _fill_icon_names(void)
+{
+	sqlite3_stmt *stmt;
+	sqlite3_stmt *update;
+	char *name;
+	ail_error_e ret = AIL_ERROR_OK;
+
+	if (sqlite3_prepare_v2(db_info.dbrw, "SELECT package, icon FROM app_info WHERE icon LIKE '/%';",
+				-1, &stmt, NULL) != SQLITE_OK) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	if (sqlite3_prepare_v2(db_info.dbrw, "UPDATE app_info SET icon = ? WHERE package = ?;",
+				-1, &update, NULL) != SQLITE_OK) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		sqlite3_finalize(stmt);
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	while (ret == AIL_ERROR_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+		/* Paths the desktop file gave itself stay */
+		name = icon_name((const char *)sqlite3_column_text(stmt, 1));
+		if (!name)
+			continue;
+
+		sqlite3_bind_text(update, 1, name, -1, SQLITE_TRANSIENT);
+		sqlite3_bind_text(update, 2, (const char *)sqlite3_column_text(stmt, 0), -1, SQLITE_TRANSIENT);
+		if (sqlite3_step(update) != SQLITE_DONE) {
+			_E("%s", sqlite3_errmsg(db_info.dbrw));
+			ret = AIL_ERROR_DB_FAILED;
+		}
+		sqlite3_reset(update);
+		free(name);
+	}
+
+	sqlite3_finalize(update);
+	sqlite3_finalize(stmt);
+
+	return ret;
+}
+
+
+
+static ail_error_e _fill_tokens(void)
 {
+	static const int props[] = {
+		E_AIL_PROP_CATEGORIES_STR,
+		E_AIL_PROP_MIMETYPE_STR,
+		E_AIL_PROP_X_SLP_SERVICE_STR,
+		E_AIL_PROP_X_SLP_PACKAGECATEGORIES_STR,
+		E_AIL_PROP_X_SLP_SVC_STR,
+	};
+	sqlite3_stmt *stmt;
+	const char *package, *value;
+	ail_error_e ret = AIL_ERROR_OK;
+	int i;
+
+	if (sqlite3_prepare_v2(db_info.dbrw, "SELECT package, categories, mimetype, "
+				"x_slp_service, x_slp_packagecategories, x_slp_svc "
+				"FROM app_info;", -1, &stmt, NULL) != SQLITE_OK) {
+		_E("%s", sqlite3_errmsg(db_info.dbrw));
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	while (ret == AIL_ERROR_OK && sqlite3_step(stmt) == SQLITE_ROW) {
+		package = (const char *)sqlite3_column_text(stmt, 0);
+		for (i = 0; ret == AIL_ERROR_OK && i < sizeof(props) / sizeof(props[0]); i++) {
+			value = (const char *)sqlite3_column_text(stmt, i + 1);
+			/* Unset fields were written with printf as "(null)" */
+			if (value && strcmp(value, "(null)"))
+				ret = db_insert_tokens(package, props[i], value);
+		}
+	}
+
+	sqlite3_finalize(stmt);
+
+	return ret;
+}
+
+
+
+ail_error_e db_upgrade(void)
+{
+	int version;
+	ail_error_e ret;
+	char query[64];
+
+	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
+
+	version = _get_int(db_info.dbrw, "PRAGMA user_version;");
+	retv_with_dbmsg_if(version < 0, AIL_ERROR_DB_FAILED);
+	if (version >= DB_SCHEMA_VERSION)
+		return AIL_ERROR_OK;
+
+	/* Not created yet, _create_table() will upgrade it */
+	if (_get_int(db_info.dbrw, "SELECT COUNT(*) FROM sqlite_master "
+				"WHERE type='table' AND name='app_info';") <= 0)
+		return AIL_ERROR_OK;
+
+	ret = db_exec("BEGIN IMMEDIATE;");
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	/* Another writer may have upgraded it meanwhile */
+	version = _get_int(db_info.dbrw, "PRAGMA user_version;");
+	if (version < 0)
+		ret = AIL_ERROR_DB_FAILED;
+
+	for (; ret == AIL_ERROR_OK && version < DB_SCHEMA_VERSION; version++) {
+		_D("Upgrade DB schema to %d", version + 1);
+		if (upgrades[version].sql)
+			ret = db_exec(upgrades[version].sql);
+		if (ret == AIL_ERROR_OK && upgrades[version].fill)
+			ret = upgrades[version].fill();
+	}
+
+	if (ret == AIL_ERROR_OK) {
+		snprintf(query, sizeof(query), "PRAGMA user_version = %d;", DB_SCHEMA_VERSION);
+		ret = db_exec(query);
+	}
+
+	if (ret != AIL_ERROR_OK) {
+		db_exec("ROLLBACK;");
+		return ret;
+	}
+
+	return db_exec("COMMIT;");
+}
+
+
+
+static const char *temp_stores[] = { "default", "file", "memory", NULL };
+static const char *synchronouses[] = { "default", "off", "normal", "full", NULL };
+
+static int _keyword(const char *keywords[], const char *value)
+{
+	int i;
+
+	for (i = 0; keywords[i]; i++) {
+		if (!strcasecmp(keywords[i], value))
+			return i;
+	}
+
+	return -1;
+}
+
+
+
+static bool _set_tuning(ail_db_config_s *config, const char *key, const char *value)
+{
+	char *end = NULL;
+	long long n;
+	int i;
+
+	if (!strcmp(key, "temp_store")) {
+		i = _keyword(temp_stores, value);
+		retv_if(i < 0, false);
+		config->temp_store = i;
+		return true;
+	}
+
+	if (!strcmp(key, "synchronous")) {
+		i = _keyword(synchronouses, value);
+		retv_if(i < 0, false);
+		config->synchronous = i;
+		return true;
+	}
+
+	n = strtoll(value, &end, 10);
+	retv_if(end == value || *end || n < 0, false);
+
+	if (!strcmp(key, "cache_size_kb") && n <= INT_MAX) {
+		config->cache_size_kb = n;
+		return true;
+	}
+
+	if (!strcmp(key, "mmap_size")) {
+		config->mmap_size = n;
+		return true;
+	}
+
+	return false;
+}
+
+
+
+/* key = value lines, # starts a comment */
+static void _load_tuning_file(ail_db_config_s *config)
+{
+	FILE *fp;
+	char line[256];
+	char *key;
+	char *value;
+	char *save;
+
+	fp = fopen(AIL_DB_CONF, "r");
+	if (!fp)
+		return;
+
+	while (fgets(line, sizeof(line), fp)) {
+		if (strchr(line, '#'))
+			*strchr(line, '#') = '\0';
+
+		key = strtok_r(line, " \t\n=", &save);
+		if (!key)
+			continue;
+		value = strtok_r(NULL, " \t\n=", &save);
+		if (!value || !_set_tuning(config, key, value))
+			_E("%s: invalid line for %s", AIL_DB_CONF, key);
+	}
+
+	fclose(fp);
+}
+
+
+
+static void _load_tuning_env(ail_db_config_s *config)
+{
+	static const struct {
+		const char *env;
+		const char *key;
+	} vars[] = {
+		{ "AIL_DB_CACHE_SIZE_KB", "cache_size_kb" },
+		{ "AIL_DB_MMAP_SIZE", "mmap_size" },
+		{ "AIL_DB_TEMP_STORE", "temp_store" },
+		{ "AIL_DB_SYNCHRONOUS", "synchronous" },
+	};
+	const char *value;
+	int i;
+
+	for (i = 0; i < sizeof(vars) / sizeof(vars[0]); i++) {
+		value = getenv(vars[i].env);
+		if (value && !_set_tuning(config, vars[i].key, value))
+			_E("Invalid %s=%s", vars[i].env, value);
+	}
+}
+
+
+
+/* Must be called with tuning.lock held */
+static void _load_tuning(void)
+{
+	if (tuning.loaded)
+		return;
+
+	_load_tuning_file(&tuning.config);
+	_load_tuning_env(&tuning.config);
+	tuning.loaded = true;
+}
+
+
+
+/* 0 fields are skipped, so a connection keeps what it had or SQLite's default */
+static void _tune(sqlite3 *db, int *tuned)
+{
+	ail_db_config_s config;
+	char query[256];
+	int version;
+	int len = 0;
+	char *errmsg = NULL;
+
+	pthread_mutex_lock(&tuning.lock);
+	_load_tuning();
+	version = tuning.version;
+	config = tuning.config;
+	pthread_mutex_unlock(&tuning.lock);
+
+	if (*tuned == version)
+		return;
+
+	if (config.cache_size_kb)
+		len += snprintf(query + len, sizeof(query) - len, "PRAGMA cache_size = -%d;", config.cache_size_kb);
+	if (config.mmap_size)
+		len += snprintf(query + len, sizeof(query) - len, "PRAGMA mmap_size = %lld;", config.mmap_size);
+	if (config.temp_store)
+		len += snprintf(query + len, sizeof(query) - len, "PRAGMA temp_store = %d;", config.temp_store);
+	if (config.synchronous)
+		len += snprintf(query + len, sizeof(query) - len, "PRAGMA synchronous = %d;", config.synchronous - 1);
+
+	if (len && sqlite3_exec(db, query, NULL, NULL, &errmsg) != SQLITE_OK) {
+		_E("Cannot tune the connection: %s", errmsg);
+		sqlite3_free(errmsg);
+	}
+
+	*tuned = version;
+}
+
+
+
+/* Must be called with context->lock held */
+static void _reap(struct ail_context *context, bool all)
+{
+	time_t now = time(NULL);
+	int n = 0;
+
+	while (n < context->n_idle && (all || now - context->idle[n].since >= context->idle_timeout)) {
+		sqlite3_close(context->idle[n].db);
+		n++;
+	}
+
+	if (!n)
+		return;
+
+	memmove(context->idle, context->idle + n, (context->n_idle - n) * sizeof(struct pooled));
+	context->n_idle -= n;
+	context->open -= n;
+}
+
+
+
+static sqlite3 *_acquire(void)
+{
+	struct ail_context *context;
+	struct timespec deadline;
+	sqlite3 *db = NULL;
 	int ret;
-	int changed = 0;
 
-	if(mode & DB_OPEN_RO) {
-		if (!db_info.dbro) {
-			ret = db_util_open_with_options(APP_INFO_DB, &db_info.dbro, SQLITE_OPEN_READONLY, NULL);
+	if (db_info.leases) {
+		db_info.leases++;
+		return db_info.dbro;
+	}
+
+	context = thread_context ? thread_context : &default_context;
+
+	pthread_mutex_lock(&context->lock);
+
+	if (!context->idle) {
+		context->idle = calloc(context->max, sizeof(struct pooled));
+		if (!context->idle) {
+			pthread_mutex_unlock(&context->lock);
+			return NULL;
+		}
+	}
+
+	_reap(context, false);
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += context->wait_ms / 1000;
+	deadline.tv_nsec += (context->wait_ms % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+	while (!context->n_idle && context->open >= context->max) {
+		if (pthread_cond_timedwait(&context->cond, &context->lock, &deadline)) {
+			/* Leases last through the callbacks of reads, max_connections may be too low */
+			_E("No connection freed in %d ms, all %d are leased", context->wait_ms, context->max);
+			pthread_mutex_unlock(&context->lock);
+			return NULL;
+		}
+	}
+
+	if (context->n_idle) {
+		context->n_idle--;
+		db = context->idle[context->n_idle].db;
+		db_info.dbro_tuned = context->idle[context->n_idle].tuned;
+	}
+	context->open += db ? 0 : 1;
+
+	pthread_mutex_unlock(&context->lock);
+
+	if (!db) {
+		TRACE_BEGIN(AIL_TRACE_DB_OPEN, "ro");
+		ret = db_util_open_with_options(APP_INFO_DB, &db, SQLITE_OPEN_READONLY, NULL);
+		TRACE_END(AIL_TRACE_DB_OPEN, "ro");
+		if (ret != SQLITE_OK) {
 			_E("db_open_ro ret=%d", ret);
-			retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
+			if (db)
+				sqlite3_close(db);
+			pthread_mutex_lock(&context->lock);
+			context->open--;
+			pthread_cond_signal(&context->cond);
+			pthread_mutex_unlock(&context->lock);
+			return NULL;
 		}
+		db_info.dbro_tuned = 0;
+		stats_watch_busy(db);
 	}
 
+	_tune(db, &db_info.dbro_tuned);
+
+	db_info.dbro = db;
+	db_info.context = context;
+	db_info.leases = 1;
+
+	return db;
+}
+
+
+
+static void _release(void)
+{
+	struct ail_context *context = db_info.context;
+
+	if (--db_info.leases)
+		return;
+
+	pthread_mutex_lock(&context->lock);
+	context->idle[context->n_idle].db = db_info.dbro;
+	context->idle[context->n_idle].since = time(NULL);
+	context->idle[context->n_idle].tuned = db_info.dbro_tuned;
+	context->n_idle++;
+	/* Also when no read leases one again for long */
+	_reap(context, false);
+	pthread_cond_signal(&context->cond);
+	pthread_mutex_unlock(&context->lock);
+
+	db_info.dbro = NULL;
+	db_info.context = NULL;
+}
+
+
+
+ail_error_e db_open(db_open_mode mode)
+{
+	int ret;
+	int changed = 0;
+
+	/* Read-only connections are leased from the context by db_prepare() */
 	if(mode & DB_OPEN_RW) {
 		if (!db_info.dbrw) {
+			TRACE_BEGIN(AIL_TRACE_DB_OPEN, "rw");
 			ret = db_util_open(APP_INFO_DB, &db_info.dbrw, DB_UTIL_REGISTER_HOOK_METHOD);
+			TRACE_END(AIL_TRACE_DB_OPEN, "rw");
 			_E("db_open_rw ret=%d", ret);
 			retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
+
+			db_info.dbrw_tuned = 0;
+			stats_watch_busy(db_info.dbrw);
+			/* Writing to the old schema would leave the new tables behind */
+			if (db_upgrade() != AIL_ERROR_OK) {
+				_E("Cannot upgrade the DB schema to %d", DB_SCHEMA_VERSION);
+				sqlite3_close(db_info.dbrw);
+				db_info.dbrw = NULL;
+				return AIL_ERROR_DB_FAILED;
+			}
 		}
+		_tune(db_info.dbrw, &db_info.dbrw_tuned);
 	}
 
 	return AIL_ERROR_OK;
@@ -75,17 +819,24 @@ ail_error_e db_open(db_open_mode mode)
 ail_error_e db_prepare(const char *query, sqlite3_stmt **stmt)
 {
 	int ret;
+	unsigned long long start;
 
 	retv_if(!query, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!stmt, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!db_info.dbro, AIL_ERROR_DB_FAILED);
+	retv_if(!_acquire(), AIL_ERROR_DB_FAILED);
 
+	TRACE_BEGIN(AIL_TRACE_DB_PREPARE, query);
+	start = stats_now();
 	ret = sqlite3_prepare_v2(db_info.dbro, query, strlen(query), stmt, NULL);
+	TRACE_END(AIL_TRACE_DB_PREPARE, query);
 	if (ret != SQLITE_OK) {
 		_E("%s\n", sqlite3_errmsg(db_info.dbro));
+		_release();
 		return AIL_ERROR_DB_FAILED;
-	} else 
+	} else {
+		stats_start(*stmt, stats_now() - start);
 		return AIL_ERROR_OK;
+	}
 }
 
 
@@ -117,13 +868,32 @@ ail_error_e db_bind_int(sqlite3_stmt *stmt, int idx, int value)
 
 
 
+ail_error_e db_bind_str(sqlite3_stmt *stmt, int idx, const char *value)
+{
+	int ret;
+
+	retv_if(!stmt, AIL_ERROR_INVALID_PARAMETER);
+
+	ret = sqlite3_bind_text(stmt, idx, value, -1, SQLITE_TRANSIENT);
+	retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
+
+	return AIL_ERROR_OK;
+}
+
+
+
 ail_error_e db_step(sqlite3_stmt *stmt)
 {
 	int ret;
+	unsigned long long start;
 
 	retv_if(!stmt, AIL_ERROR_INVALID_PARAMETER);
 
+	TRACE_BEGIN(AIL_TRACE_DB_STEP, sqlite3_sql(stmt));
+	start = stats_now();
 	ret = sqlite3_step(stmt);
+	stats_step(stmt, stats_now() - start, ret == SQLITE_ROW);
+	TRACE_END(AIL_TRACE_DB_STEP, sqlite3_sql(stmt));
 	switch (ret) {
 		case SQLITE_DONE:
 			return AIL_ERROR_NO_DATA;
@@ -181,6 +951,7 @@ ail_error_e db_reset(sqlite3_stmt *stmt)
 
 	retv_if(!stmt, AIL_ERROR_INVALID_PARAMETER);
 
+	stats_end(stmt, true);
 	sqlite3_clear_bindings(stmt);
 
 	ret = sqlite3_reset(stmt);
@@ -194,10 +965,15 @@ ail_error_e db_reset(sqlite3_stmt *stmt)
 ail_error_e db_finalize(sqlite3_stmt *stmt)
 {
 	int ret;
+	bool leased;
 
 	retv_if(!stmt, AIL_ERROR_INVALID_PARAMETER);
 
+	stats_end(stmt, false);
+	leased = db_info.leases && sqlite3_db_handle(stmt) == db_info.dbro;
 	ret = sqlite3_finalize(stmt);
+	if (leased)
+		_release();
 	retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
 
 	return AIL_ERROR_OK;
@@ -209,11 +985,14 @@ ail_error_e db_exec(const char *query)
 {
 	int ret;
 	char *errmsg;
+	unsigned long long start;
 
 	retv_if(!query, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
 
+	start = stats_now();
 	ret = sqlite3_exec(db_info.dbrw, query, NULL, NULL, &errmsg);
+	stats_exec(db_info.dbrw, query, stats_now() - start);
 	if (ret != SQLITE_OK) {
 		_E("Cannot execute this query - %s. because %s",
 				query, errmsg? errmsg:"uncatched error");
@@ -226,16 +1005,330 @@ ail_error_e db_exec(const char *query)
 
 
 
-ail_error_e db_close(void)
+static unsigned long long *_map_generation(bool writable)
+{
+	struct stat st;
+	void *addr;
+	int fd;
+
+	if (writable)
+		fd = open(APP_INFO_GENERATION, O_RDWR | O_CREAT, 0644);
+	else
+		fd = open(APP_INFO_GENERATION, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return NULL;
+	}
+
+	if (st.st_size < sizeof(unsigned long long)) {
+		/* Zero-filled, it reads as generation 0 */
+		if (!writable || ftruncate(fd, sizeof(unsigned long long)) < 0) {
+			close(fd);
+			return NULL;
+		}
+	}
+
+	addr = mmap(NULL, sizeof(unsigned long long),
+			writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED) {
+		_E("Cannot map %s", APP_INFO_GENERATION);
+		return NULL;
+	}
+
+	return addr;
+}
+
+
+
+bool db_read_generation(unsigned long long *value)
+{
+	time_t now;
+
+	retv_if(!value, false);
+
+	pthread_mutex_lock(&generation.lock);
+	if (!generation.ro) {
+		now = time(NULL);
+		if (now != generation.ro_failed) {
+			generation.ro = _map_generation(false);
+			if (!generation.ro)
+				generation.ro_failed = now;
+		}
+	}
+	pthread_mutex_unlock(&generation.lock);
+
+	if (!generation.ro)
+		return false;
+
+	*value = __atomic_load_n(generation.ro, __ATOMIC_ACQUIRE);
+
+	return true;
+}
+
+
+
+/* app_name_fts is left out of DBs upgraded by a SQLite without FTS4 */
+bool db_has_name_index(void)
+{
+	static int found;	/* never dropped once created */
+	sqlite3_stmt *stmt;
+	int n = 0;
+
+	if (__atomic_load_n(&found, __ATOMIC_ACQUIRE))
+		return true;
+
+	if (db_prepare("SELECT COUNT(*) FROM sqlite_master "
+				"WHERE type='table' AND name='app_name_fts';", &stmt) != AIL_ERROR_OK)
+		return false;
+	if (db_step(stmt) == AIL_ERROR_OK)
+		db_column_int(stmt, 0, &n);
+	db_finalize(stmt);
+
+	if (n > 0)
+		__atomic_store_n(&found, 1, __ATOMIC_RELEASE);
+
+	return n > 0;
+}
+
+
+
+static unsigned long long _select_generation(sqlite3 *db)
+{
+	sqlite3_stmt *stmt;
+	unsigned long long value = 0;
+
+	if (sqlite3_prepare_v2(db, "SELECT value FROM generation;", -1, &stmt, NULL) != SQLITE_OK)
+		return 0;
+
+	if (sqlite3_step(stmt) == SQLITE_ROW)
+		value = sqlite3_column_int64(stmt, 0);
+
+	sqlite3_finalize(stmt);
+
+	return value;
+}
+
+
+
+/* Called inside the transaction of the change, db_publish_generation() once committed */
+ail_error_e db_bump_generation(unsigned long long *value)
+{
+	unsigned long long *mapped, current;
+	ail_error_e ret;
+	char query[128];
+
+	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
+
+	pthread_mutex_lock(&generation.lock);
+	if (!generation.rw)
+		generation.rw = _map_generation(true);
+	mapped = generation.rw;
+	pthread_mutex_unlock(&generation.lock);
+
+	current = mapped ? __atomic_load_n(mapped, __ATOMIC_ACQUIRE) : 0;
+
+	/* The file outlives a DB recreated by ail_initdb, never go back */
+	snprintf(query, sizeof(query),
+			"UPDATE generation SET value = max(value, %llu) + 1;", current);
+	ret = db_exec(query);
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	*value = _select_generation(db_info.dbrw);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+void db_publish_generation(unsigned long long value)
+{
+	unsigned long long *mapped, current;
+
+	pthread_mutex_lock(&generation.lock);
+	mapped = generation.rw;
+	pthread_mutex_unlock(&generation.lock);
+
+	if (!mapped)
+		return;
+
+	/* Writers may finish out of order, keep the larger one */
+	current = __atomic_load_n(mapped, __ATOMIC_ACQUIRE);
+	while (current < value &&
+			!__atomic_compare_exchange_n(mapped, &current, value, false,
+				__ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+		;
+}
+
+
+
+ail_error_e db_log_change(ail_change_type_e type, const char *package, unsigned long long *seq)
 {
+	sqlite3_stmt *stmt;
+	char query[128];
 	int ret;
 
-	if(db_info.dbro) {
-		ret = sqlite3_close(db_info.dbro);
-		retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
+	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!db_info.dbrw, AIL_ERROR_DB_FAILED);
+
+	ret = sqlite3_prepare_v2(db_info.dbrw, "INSERT INTO change_log (type, package) "
+			"VALUES (?, ?);", -1, &stmt, NULL);
+	retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
+
+	sqlite3_bind_int(stmt, 1, type);
+	sqlite3_bind_text(stmt, 2, package, -1, SQLITE_STATIC);
+	ret = sqlite3_step(stmt);
+	sqlite3_finalize(stmt);
+	retv_with_dbmsg_if(ret != SQLITE_DONE, AIL_ERROR_DB_FAILED);
+
+	if (seq)
+		*seq = sqlite3_last_insert_rowid(db_info.dbrw);
+
+	snprintf(query, sizeof(query), "DELETE FROM change_log WHERE seq <= %lld;",
+			(long long)sqlite3_last_insert_rowid(db_info.dbrw) - CHANGE_LOG_MAX);
+
+	return db_exec(query);
+}
+
+
+
+EXPORT_API ail_error_e ail_changes_get_latest(unsigned long long *seq)
+{
+	sqlite3_stmt *stmt;
+	ail_error_e ret;
+
+	retv_if(!seq, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(db_open(DB_OPEN_RO) < 0, AIL_ERROR_DB_FAILED);
+
+	/* Also right once every entry is trimmed */
+	ret = db_prepare("SELECT seq FROM sqlite_sequence WHERE name = 'change_log';", &stmt);
+	retv_if(ret < 0, ret);
+
+	*seq = 0;
+	ret = db_step(stmt);
+	if (ret == AIL_ERROR_OK)
+		*seq = sqlite3_column_int64(stmt, 0);
+
+	db_finalize(stmt);
+
+	return (ret == AIL_ERROR_NO_DATA) ? AIL_ERROR_OK : ret;
+}
+
 
-		db_info.dbro = NULL;
+
+static ail_error_e _changes_since(unsigned long long seq, ail_change_cb cb, void *user_data)
+{
+	sqlite3_stmt *stmt;
+	unsigned long long latest, row_seq;
+	ail_error_e ret;
+	bool first = true;
+
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(db_open(DB_OPEN_RO) < 0, AIL_ERROR_DB_FAILED);
+
+	ret = db_prepare("SELECT seq, type, package FROM change_log "
+			"WHERE seq > ? ORDER BY seq;", &stmt);
+	retv_if(ret < 0, ret);
+
+	if (sqlite3_bind_int64(stmt, 1, seq) != SQLITE_OK) {
+		db_finalize(stmt);
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	while ((ret = db_step(stmt)) == AIL_ERROR_OK) {
+		row_seq = sqlite3_column_int64(stmt, 0);
+		/* seq is gapless, a hole after seq means it was trimmed */
+		if (first && row_seq != seq + 1) {
+			ret = AIL_ERROR_EXPIRED;
+			break;
+		}
+		first = false;
+
+		if (cb(row_seq, sqlite3_column_int(stmt, 1),
+				(const char *)sqlite3_column_text(stmt, 2), user_data) == AIL_CB_RET_CANCEL) {
+			ret = AIL_ERROR_NO_DATA;
+			break;
+		}
+	}
+
+	db_finalize(stmt);
+
+	if (ret != AIL_ERROR_NO_DATA)
+		return ret;
+
+	if (first) {
+		/* Nothing newer, unless the DB was recreated since seq */
+		ret = ail_changes_get_latest(&latest);
+		retv_if(ret != AIL_ERROR_OK, ret);
+		retv_if(seq > latest, AIL_ERROR_EXPIRED);
+	}
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_changes_since(unsigned long long seq, ail_change_cb cb, void *user_data)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _changes_since(seq, cb, user_data);
+	if (recording) {
+		record_arg_int64(&rec, seq);
+		record_end(&rec, RECORD_CHANGES_SINCE, ret);
+	}
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_db_get_generation(unsigned long long *value)
+{
+	sqlite3_stmt *stmt;
+	ail_error_e ret;
+
+	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
+
+	if (db_read_generation(value))
+		return AIL_ERROR_OK;
+
+	/* Nothing was written since the file went away, the DB still knows */
+	retv_if(db_open(DB_OPEN_RO) < 0, AIL_ERROR_DB_FAILED);
+
+	ret = db_prepare("SELECT value FROM generation;", &stmt);
+	retv_if(ret < 0, ret);
+
+	ret = db_step(stmt);
+	if (ret == AIL_ERROR_OK)
+		*value = sqlite3_column_int64(stmt, 0);
+
+	db_finalize(stmt);
+
+	return ret;
+}
+
+
+
+ail_error_e db_close(void)
+{
+	struct ail_context *context = thread_context ? thread_context : &default_context;
+	int ret;
+
+	/* Idle connections of the context, leased ones go back to it */
+	if (!db_info.leases) {
+		pthread_mutex_lock(&context->lock);
+		_reap(context, true);
+		pthread_mutex_unlock(&context->lock);
 	}
+
 	if(db_info.dbrw) {
 		ret = sqlite3_close(db_info.dbrw);
 		retv_with_dbmsg_if(ret != SQLITE_OK, AIL_ERROR_DB_FAILED);
@@ -252,4 +1345,133 @@ EXPORT_API ail_error_e ail_db_close(void)
 }
 
 
+
+EXPORT_API ail_error_e ail_db_config(const ail_db_config_s *config)
+{
+	retv_if(!config, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config->cache_size_kb < 0 || config->mmap_size < 0, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config->temp_store < AIL_DB_TEMP_STORE_DEFAULT || config->temp_store > AIL_DB_TEMP_STORE_MEMORY, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config->synchronous < AIL_DB_SYNCHRONOUS_DEFAULT || config->synchronous > AIL_DB_SYNCHRONOUS_FULL, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&tuning.lock);
+	tuning.config = *config;
+	tuning.loaded = true;
+	tuning.version++;
+	pthread_mutex_unlock(&tuning.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_db_get_config(ail_db_config_s *config)
+{
+	retv_if(!config, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&tuning.lock);
+	_load_tuning();
+	*config = tuning.config;
+	pthread_mutex_unlock(&tuning.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_db_upgrade(void)
+{
+	/* Opening for writing upgrades the schema, unless it was opened before */
+	retv_if(db_open(DB_OPEN_RW) != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
+
+	return db_upgrade();
+}
+
+
+
+EXPORT_API ail_error_e ail_db_invalidate(void)
+{
+	unsigned long long generation = 0;
+	ail_error_e ret;
+
+	retv_if(db_open(DB_OPEN_RW) != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
+
+	ret = db_exec("BEGIN IMMEDIATE;");
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	/* Past both the file and the replaced DB, whichever is ahead */
+	ret = db_bump_generation(&generation);
+	if (ret != AIL_ERROR_OK) {
+		db_exec("ROLLBACK;");
+		return ret;
+	}
+
+	ret = db_exec("COMMIT;");
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	db_publish_generation(generation);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_context_create(const ail_context_config_s *config, ail_context_h *context)
+{
+	struct ail_context *c;
+
+	retv_if(!context, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config && config->max_connections < 0, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config && config->idle_timeout < 0, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(config && config->wait_ms < 0, AIL_ERROR_INVALID_PARAMETER);
+
+	c = calloc(1, sizeof(struct ail_context));
+	retv_if(!c, AIL_ERROR_OUT_OF_MEMORY);
+
+	pthread_mutex_init(&c->lock, NULL);
+	pthread_cond_init(&c->cond, NULL);
+	c->max = (config && config->max_connections) ? config->max_connections : CONTEXT_CONNECTIONS_DEFAULT;
+	c->idle_timeout = (config && config->idle_timeout) ? config->idle_timeout : CONTEXT_IDLE_TIMEOUT_DEFAULT;
+	c->wait_ms = (config && config->wait_ms) ? config->wait_ms : CONTEXT_WAIT_MS_DEFAULT;
+
+	*context = c;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_context_destroy(ail_context_h context)
+{
+	retv_if(!context, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&context->lock);
+	_reap(context, true);
+	if (context->open) {
+		_E("%d connections of the context are still in use", context->open);
+		pthread_mutex_unlock(&context->lock);
+		return AIL_ERROR_FAIL;
+	}
+	pthread_mutex_unlock(&context->lock);
+
+	if (thread_context == context)
+		thread_context = NULL;
+
+	pthread_cond_destroy(&context->cond);
+	pthread_mutex_destroy(&context->lock);
+	free(context->idle);
+	free(context);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_context_set_thread_default(ail_context_h context)
+{
+	thread_context = context;
+
+	return AIL_ERROR_OK;
+}
+
+
 // End of file.
@@ -30,6 +30,9 @@
 
 #define AIL_SQL_QUERY_MAX_LEN	2048
 
+/* PRAGMA user_version of a DB with every upgrade applied */
+#define DB_SCHEMA_VERSION	8
+
 typedef enum {
 	DB_OPEN_RO = 0x0001,
 	DB_OPEN_RW = 0x0002,
@@ -40,6 +43,7 @@ ail_error_e db_prepare(const char *query, sqlite3_stmt **stmt);
 
 ail_error_e db_bind_bool(sqlite3_stmt *stmt, int idx, bool value);
 ail_error_e db_bind_int(sqlite3_stmt *stmt, int idx, int value);
+ail_error_e db_bind_str(sqlite3_stmt *stmt, int idx, const char *value);
 
 ail_error_e db_step(sqlite3_stmt *stmt);
 
@@ -52,6 +56,14 @@ ail_error_e db_finalize(sqlite3_stmt *stmt);
 
 
 ail_error_e db_exec(const char *query);
+ail_error_e db_upgrade(void);
+ail_error_e db_insert_tokens(const char *package, int prop, const char *value);
+ail_error_e db_insert_exe_path(const char *package, const char *path);
+ail_error_e db_bump_generation(unsigned long long *value);
+void db_publish_generation(unsigned long long value);
+bool db_read_generation(unsigned long long *value);
+bool db_has_name_index(void);
+ail_error_e db_log_change(ail_change_type_e type, const char *package, unsigned long long *seq);
 ail_error_e db_close(void);
 
 #endif
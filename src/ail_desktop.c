@@ -35,11 +35,16 @@
 #include <glib.h>
 
 #include "ail_private.h"
+#include "ail_convert.h"
 #include "ail_db.h"
+#include "ail_cache.h"
+#include "ail_snapshot.h"
+#include "ail_trace.h"
+#include "ail_record.h"
 #include "ail.h"
 
-#define OPT_DESKTOP_DIRECTORY "/opt/share/applications"
-#define USR_DESKTOP_DIRECTORY "/usr/share/applications"
+#define OPT_DESKTOP_DIRECTORY AIL_ROOT"/opt/share/applications"
+#define USR_DESKTOP_DIRECTORY AIL_ROOT"/usr/share/applications"
 #define BUFSZE 4096
 
 #define whitespace(c) (((c) == ' ') || ((c) == '\t'))
@@ -112,6 +117,14 @@ typedef struct {
 	GSList*		localname;
 } desktop_info_s;
 
+/* Changes committed since the outermost ail_desktop_batch_begin() */
+static __thread struct {
+	int depth;
+	unsigned long long first;
+	unsigned long long last;
+	bool snapshot;	/* withdrawn by the batch, published again at its end */
+} batch;
+
 
 
 static ail_error_e _read_exec(void *data, char *tag, char *value)
@@ -205,102 +218,6 @@ static ail_error_e _read_type(void *data, char *tag, char *value)
 }
 
 
-static char*
-_get_package_from_icon(char* icon)
-{
-	char* package;
-	char* extension;
-
-	retv_if(!icon, NULL);
-
-	package = strdup(icon);
-	retv_if(!package, NULL);
-	extension = rindex(package, '.');
-	if (extension) {
-		*extension = '\0';
-	} else {
-		_E("cannot extract from icon [%s] to package.", icon);
-	}
-
-	return package;
-}
-
-
-static char*
-_get_icon_with_path(char* icon)
-{
-	retv_if(!icon, NULL);
-
-	if (index(icon, '/') == NULL) {
-		char* package;
-		char* theme = NULL;
-		char* icon_with_path = NULL;
-		int len;
-
-		package = _get_package_from_icon(icon);
-		retv_if(!package, NULL);
-
-		theme = vconf_get_str("db/setting/theme");
-		if (!theme) {
-			theme = strdup("default");
-			if(!theme) {
-				free(package);
-				return NULL;
-			}
-		}
-
-		len = (0x01 << 7) + strlen(icon) + strlen(package) + strlen(theme);
-		icon_with_path = malloc(len);
-		if(icon_with_path == NULL) {
-			_E("(icon_with_path == NULL) return\n");
-			free(package);
-			free(theme);
-			return NULL;
-		}
-
-		memset(icon_with_path, 0, len);
-
-		snprintf(icon_with_path, len, "/opt/share/icons/%s/small/%s", theme, icon);
-		do {
-			if (access(icon_with_path, R_OK) == 0) break;
-			snprintf(icon_with_path, len, "/usr/share/icons/%s/small/%s", theme, icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			_D("cannot find icon %s", icon_with_path);
-			snprintf(icon_with_path, len, "/opt/share/icons/default/small/%s", icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			snprintf(icon_with_path, len, "/usr/share/icons/default/small/%s", icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-
-			#if 1 /* this will be remove when finish the work for moving icon path */
-			_E("icon file must be moved to %s", icon_with_path);
-			snprintf(icon_with_path, len, "/opt/apps/%s/res/icons/%s/small/%s", package, theme, icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			snprintf(icon_with_path, len, "/usr/apps/%s/res/icons/%s/small/%s", package, theme, icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			_D("cannot find icon %s", icon_with_path);
-			snprintf(icon_with_path, len, "/opt/apps/%s/res/icons/default/small/%s", package, icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			snprintf(icon_with_path, len, "/usr/apps/%s/res/icons/default/small/%s", package, icon);
-			if (access(icon_with_path, R_OK) == 0) break;
-			#endif
-		} while (0);
-
-		free(theme);
-		free(package);
-
-		_D("Icon path : %s ---> %s", icon, icon_with_path);
-
-		return icon_with_path;
-	} else {
-		char* confirmed_icon = NULL;
-
-		confirmed_icon = strdup(icon);
-		retv_if(!confirmed_icon, NULL);
-		return confirmed_icon;
-	}
-}
-
-
 static ail_error_e _read_icon(void *data, char *tag, char *value)
 {
 	desktop_info_s *info = data;
@@ -308,8 +225,8 @@ static ail_error_e _read_icon(void *data, char *tag, char *value)
 	retv_if(!data, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
 
-	info->icon = _get_icon_with_path(value);
-
+	/* Stored as written, readers resolve it for their theme */
+	SAFE_FREE_AND_STRDUP(value, info->icon);
 	retv_if (!info->icon, AIL_ERROR_OUT_OF_MEMORY);
 
 	return AIL_ERROR_OK;
@@ -377,7 +294,9 @@ static ail_error_e _read_mimetype(void *data, char *tag, char *value)
 		_rtrim(token_unalias);
 		token_unalias = _ltrim(token_unalias);
 
+		TRACE_BEGIN(AIL_TRACE_MIME_UNALIAS, token_unalias);
 		token_alias = xdg_mime_unalias_mime_type(token_unalias);
+		TRACE_END(AIL_TRACE_MIME_UNALIAS, token_unalias);
 		if (!token_alias) continue;
 
 		token_len = strlen(token_alias);
@@ -782,6 +701,8 @@ static ail_error_e _read_desktop_info(desktop_info_s* info)
 	fp = fopen(info->desktop, "r");
 	retv_if(!fp, AIL_ERROR_FAIL);
 
+	TRACE_BEGIN(AIL_TRACE_DESKTOP_PARSE, info->desktop);
+
 	while ((read = getline(&line, &size, fp)) != -1) {
 		int len, idx;
 		char *tmp, *field, *field_name, *tag, *value;
@@ -829,6 +750,8 @@ NEXT:
 	_D("Read (%s).", info->package);
 	fclose(fp);
 
+	TRACE_END(AIL_TRACE_DESKTOP_PARSE, info->desktop);
+
 	return AIL_ERROR_OK;
 }
 
@@ -907,6 +830,9 @@ static ail_error_e _create_table(void)
 		retv_if(ret != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
 	}
 
+	ret = db_upgrade();
+	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
+
 	return AIL_ERROR_OK;
 }
 
@@ -925,6 +851,26 @@ static inline void _insert_localname(gpointer data, gpointer user_data)
 		_E("Failed to insert local name of package[%s]",info->package);
 }
 
+static ail_error_e _insert_tokens(desktop_info_s *info)
+{
+	ail_error_e ret;
+
+	ret = db_insert_tokens(info->package, E_AIL_PROP_CATEGORIES_STR, info->categories);
+	retv_if(ret != AIL_ERROR_OK, ret);
+	ret = db_insert_tokens(info->package, E_AIL_PROP_MIMETYPE_STR, info->mimetype);
+	retv_if(ret != AIL_ERROR_OK, ret);
+	ret = db_insert_tokens(info->package, E_AIL_PROP_X_SLP_SERVICE_STR, info->x_slp_service);
+	retv_if(ret != AIL_ERROR_OK, ret);
+	ret = db_insert_tokens(info->package, E_AIL_PROP_X_SLP_PACKAGECATEGORIES_STR, info->x_slp_packagecategories);
+	retv_if(ret != AIL_ERROR_OK, ret);
+	ret = db_insert_tokens(info->package, E_AIL_PROP_X_SLP_SVC_STR, info->x_slp_svc);
+	retv_if(ret != AIL_ERROR_OK, ret);
+	ret = db_insert_exe_path(info->package, info->x_slp_exe_path);
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	return AIL_ERROR_OK;
+}
+
 static ail_error_e _insert_desktop_info(desktop_info_s *info)
 {
 	char *query;
@@ -1007,6 +953,12 @@ static ail_error_e _insert_desktop_info(desktop_info_s *info)
 	if (info->localname)
 		g_slist_foreach(info->localname, _insert_localname, info);
 
+	/* Without its tokens the package would be missed by lookups, roll it back */
+	if (_insert_tokens(info) < 0) {
+		_E("Failed to insert list entries of package[%s]", info->package);
+		return AIL_ERROR_DB_FAILED;
+	}
+
 	_D("Add (%s).", info->package);
 
 	return AIL_ERROR_OK;
@@ -1096,6 +1048,19 @@ static ail_error_e _update_desktop_info(desktop_info_s *info)
 	if (info->localname)
 		g_slist_foreach(info->localname, _insert_localname, info);
 
+	snprintf(query, len, "delete from app_token where package = '%s'", info->package);
+
+	if (db_exec(query) < 0) {
+		free (query);
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	if (_insert_tokens(info) < 0) {
+		_E("Failed to insert list entries of package[%s]", info->package);
+		free(query);
+		return AIL_ERROR_DB_FAILED;
+	}
+
 	_D("Update (%s).", info->package);
 
 	free(query);
@@ -1135,6 +1100,13 @@ static ail_error_e _remove_package(const char* package)
 		return AIL_ERROR_DB_FAILED;
 	}
 
+	snprintf(query, size, "delete from app_token where package = '%s'", package);
+
+	if (db_exec(query) < 0) {
+		free(query);
+		return AIL_ERROR_DB_FAILED;
+	}
+
 	_D("Remove (%s).", package);
 	free(query);
 
@@ -1143,6 +1115,75 @@ static ail_error_e _remove_package(const char* package)
 
 
 
+static ail_error_e _begin(void)
+{
+	retv_if(db_open(DB_OPEN_RW) < 0, AIL_ERROR_DB_FAILED);
+
+	return db_exec("BEGIN IMMEDIATE;");
+}
+
+
+
+/* The journal entry and the generation commit with the data, or none does */
+static ail_error_e _commit(ail_error_e ret, noti_type type, const char *package)
+{
+	static const ail_change_type_e changes[NOTI_MAX] = {
+		[NOTI_ADD] = AIL_CHANGE_CREATE,
+		[NOTI_UPDATE] = AIL_CHANGE_UPDATE,
+		[NOTI_REMOVE] = AIL_CHANGE_DELETE,
+	};
+	unsigned long long seq = 0;
+	unsigned long long generation = 0;
+
+	if (ret == AIL_ERROR_OK)
+		ret = db_log_change(changes[type], package, &seq);
+
+	if (ret == AIL_ERROR_OK)
+		ret = db_bump_generation(&generation);
+
+	if (ret != AIL_ERROR_OK) {
+		db_exec("ROLLBACK;");
+		return ret;
+	}
+
+	ret = db_exec("COMMIT;");
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	db_publish_generation(generation);
+
+	if (batch.depth) {
+		if (!batch.first)
+			batch.first = seq;
+		batch.last = seq;
+	}
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static void _publish(const char *noti, const char *package)
+{
+	/* initdb publishes the snapshot once all packages are loaded */
+	if (batch.snapshot) {
+		batch.snapshot = false;
+		if (snapshot_publish() != AIL_ERROR_OK)
+			_E("Cannot publish the snapshot again, readers stay on the DB");
+	} else if (!__is_ail_initdb())
+		snapshot_republish();
+
+	/* The new generation already dropped every record of a batch */
+	if (package)
+		cache_invalidate_package(package);
+
+	TRACE_BEGIN(AIL_TRACE_NOTIFY_SEND, noti);
+	vconf_set_str(AIL_NOTI_KEY, noti);
+	TRACE_END(AIL_TRACE_NOTIFY_SEND, noti);
+	_D("Noti : %s", noti);
+}
+
+
+
 static ail_error_e _send_db_done_noti(noti_type type, const char *package)
 {
 	char *type_string, *noti_string;
@@ -1150,6 +1191,15 @@ static ail_error_e _send_db_done_noti(noti_type type, const char *package)
 
 	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
 
+	/* ail_desktop_batch_end() publishes the whole batch at once */
+	if (batch.depth) {
+		/* A stale snapshot would hide the change, from this process too */
+		if (!__is_ail_initdb() && snapshot_withdraw())
+			batch.snapshot = true;
+		cache_invalidate_package(package);
+		return AIL_ERROR_OK;
+	}
+
 	switch (type) {
 		case NOTI_ADD:
 			type_string = "create";
@@ -1169,8 +1219,7 @@ static ail_error_e _send_db_done_noti(noti_type type, const char *package)
 	retv_if(!noti_string, AIL_ERROR_OUT_OF_MEMORY);
 
 	snprintf(noti_string, size, "%s:%s", type_string, package);
-	vconf_set_str("memory/menuscreen/desktop", noti_string);
-	_D("Noti : %s", noti_string);
+	_publish(noti_string, package);
 
 	free(noti_string);
 
@@ -1218,8 +1267,7 @@ static void _fini_desktop_info(desktop_info_s *info)
 
 
 
-/* Public functions */
-EXPORT_API ail_error_e ail_desktop_add(const char *package)
+static ail_error_e _desktop_add(const char *package)
 {
 	desktop_info_s info = {0,};
 	ail_error_e ret;
@@ -1241,7 +1289,10 @@ EXPORT_API ail_error_e ail_desktop_add(const char *package)
 	ret = _read_desktop_info(&info);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
-	ret = _insert_desktop_info(&info);
+	ret = _begin();
+	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
+
+	ret = _commit(_insert_desktop_info(&info), NOTI_ADD, package);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
 	ret = _send_db_done_noti(NOTI_ADD, package);
@@ -1254,7 +1305,7 @@ EXPORT_API ail_error_e ail_desktop_add(const char *package)
 
 
 
-EXPORT_API ail_error_e ail_desktop_update(const char *package)
+static ail_error_e _desktop_update(const char *package)
 {
 	desktop_info_s info = {0,};
 	ail_error_e ret;
@@ -1267,7 +1318,10 @@ EXPORT_API ail_error_e ail_desktop_update(const char *package)
 	ret = _read_desktop_info(&info);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
-	ret = _update_desktop_info(&info);
+	ret = _begin();
+	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
+
+	ret = _commit(_update_desktop_info(&info), NOTI_UPDATE, package);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
 	ret = _send_db_done_noti(NOTI_UPDATE, package);
@@ -1280,13 +1334,16 @@ EXPORT_API ail_error_e ail_desktop_update(const char *package)
 
 
 
-EXPORT_API ail_error_e ail_desktop_remove(const char *package)
+static ail_error_e _desktop_remove(const char *package)
 {
 	ail_error_e ret;
 
 	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
 
-	ret = _remove_package(package);
+	ret = _begin();
+	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
+
+	ret = _commit(_remove_package(package), NOTI_REMOVE, package);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
 	ret = _send_db_done_noti(NOTI_REMOVE, package);
@@ -1296,9 +1353,40 @@ EXPORT_API ail_error_e ail_desktop_remove(const char *package)
 }
 
 
-EXPORT_API ail_error_e ail_desktop_appinfo_modify_bool(const char *package,
-							     const char *property,
-							     bool value)
+static ail_error_e _batch_begin(void)
+{
+	batch.depth++;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static ail_error_e _batch_end(void)
+{
+	char noti[64];
+
+	retv_if(batch.depth <= 0, AIL_ERROR_FAIL);
+
+	if (--batch.depth)
+		return AIL_ERROR_OK;
+
+	if (!batch.first)
+		return AIL_ERROR_OK;
+
+	/* "batch:<first seq>-<last seq>", ail_changes_since() has the details */
+	snprintf(noti, sizeof(noti), "batch:%llu-%llu", batch.first, batch.last);
+	_publish(noti, NULL);
+
+	batch.first = 0;
+	batch.last = 0;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static ail_error_e _appinfo_modify_bool(const char *package, const char *property, bool value)
 {
 	desktop_info_s info = {0,};
 	ail_error_e ret;
@@ -1315,7 +1403,10 @@ EXPORT_API ail_error_e ail_desktop_appinfo_modify_bool(const char *package,
 	ret = _modify_desktop_info_bool(&info, property, value);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
-	ret = _update_desktop_info(&info);
+	ret = _begin();
+	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
+
+	ret = _commit(_update_desktop_info(&info), NOTI_UPDATE, package);
 	retv_if(ret != AIL_ERROR_OK, AIL_ERROR_FAIL);
 
 	ret = _send_db_done_noti(NOTI_UPDATE, package);
@@ -1327,6 +1418,114 @@ EXPORT_API ail_error_e ail_desktop_appinfo_modify_bool(const char *package,
 }
 
 
+/* Public functions */
+EXPORT_API ail_error_e ail_desktop_add(const char *package)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _desktop_add(package);
+	if (recording) {
+		record_arg_str(&rec, package);
+		record_end(&rec, RECORD_DESKTOP_ADD, ret);
+	}
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_desktop_update(const char *package)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _desktop_update(package);
+	if (recording) {
+		record_arg_str(&rec, package);
+		record_end(&rec, RECORD_DESKTOP_UPDATE, ret);
+	}
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_desktop_remove(const char *package)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _desktop_remove(package);
+	if (recording) {
+		record_arg_str(&rec, package);
+		record_end(&rec, RECORD_DESKTOP_REMOVE, ret);
+	}
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_desktop_batch_begin(void)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _batch_begin();
+	if (recording)
+		record_end(&rec, RECORD_DESKTOP_BATCH_BEGIN, ret);
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_desktop_batch_end(void)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _batch_end();
+	if (recording)
+		record_end(&rec, RECORD_DESKTOP_BATCH_END, ret);
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_desktop_appinfo_modify_bool(const char *package,
+							     const char *property,
+							     bool value)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _appinfo_modify_bool(package, property, value);
+	if (recording) {
+		record_arg_str(&rec, package);
+		record_arg_str(&rec, property);
+		record_arg_byte(&rec, value);
+		record_end(&rec, RECORD_DESKTOP_MODIFY_BOOL, ret);
+	}
+
+	return ret;
+}
+
+
 
 
 // End of File
@@ -31,11 +31,28 @@
 #include "ail_sql.h"
 #include "ail_package.h"
 #include "ail_db.h"
+#include "ail_snapshot.h"
+#include "ail_filter.h"
+#include "ail_record.h"
 
-char *_get_where_clause(ail_filter_h filter);
+char *_get_where_clause(ail_filter_h filter, const char *locale);
 
 struct ail_filter {
 	GSList *list;
+	char *search;	/* lowercase terms separated by one space */
+};
+
+/* Packages bound in one keyed query of a watch */
+#define WATCH_CHUNK	64
+
+struct ail_filter_watch {
+	ail_filter_h filter;
+	ail_filter_watch_cb cb;
+	void *user_data;
+	GHashTable *matches;	/* packages matching at the last delivery */
+	ail_changes_subscription_h sub;
+	bool busy;		/* in cb, unwatch only marks it dead */
+	bool dead;
 };
 
 static inline void _add_cond_to_filter(ail_filter_h filter, struct element *cond)
@@ -85,20 +102,15 @@ EXPORT_API ail_error_e ail_filter_destroy(ail_filter_h filter)
 		g_slist_free(filter->list);
 	}
 
+	SAFE_FREE(filter->search);
 	free(filter);
 
 	return AIL_ERROR_OK;
 }
 
-EXPORT_API ail_error_e ail_filter_add_bool(ail_filter_h filter, const char *property, bool value)
+static ail_error_e _filter_add_bool(ail_filter_h filter, ail_prop_bool_e prop, bool value)
 {
 	struct element *c;
-	ail_prop_bool_e prop;
-
-	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
-	retv_if (NULL == property, AIL_ERROR_INVALID_PARAMETER);
-
-	prop = _ail_convert_to_prop_bool(property);
 
 	if (prop < E_AIL_PROP_BOOL_MIN || prop > E_AIL_PROP_BOOL_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
@@ -114,15 +126,24 @@ EXPORT_API ail_error_e ail_filter_add_bool(ail_filter_h filter, const char *prop
 	return AIL_ERROR_OK;
 }
 
-EXPORT_API ail_error_e ail_filter_add_int(ail_filter_h filter, const char *property, int value)
+EXPORT_API ail_error_e ail_filter_add_bool(ail_filter_h filter, const char *property, bool value)
 {
-	struct element *c;
-	ail_prop_int_e prop;
-
 	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
 	retv_if (NULL == property, AIL_ERROR_INVALID_PARAMETER);
 
-	prop = _ail_convert_to_prop_int(property);
+	return _filter_add_bool(filter, _ail_convert_to_prop_bool(property), value);
+}
+
+EXPORT_API ail_error_e ail_filter_add_bool_by_id(ail_filter_h filter, ail_prop_id_e id, bool value)
+{
+	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
+
+	return _filter_add_bool(filter, (ail_prop_bool_e)id, value);
+}
+
+static ail_error_e _filter_add_int(ail_filter_h filter, ail_prop_int_e prop, int value)
+{
+	struct element *c;
 
 	if (prop < E_AIL_PROP_INT_MIN || prop > E_AIL_PROP_INT_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
@@ -138,15 +159,24 @@ EXPORT_API ail_error_e ail_filter_add_int(ail_filter_h filter, const char *prope
 	return AIL_ERROR_OK;
 }
 
-EXPORT_API ail_error_e ail_filter_add_str(ail_filter_h filter, const char *property, const char *value)
+EXPORT_API ail_error_e ail_filter_add_int(ail_filter_h filter, const char *property, int value)
 {
-	struct element *c; //condition
-	ail_prop_str_e prop;
-
 	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
 	retv_if (NULL == property, AIL_ERROR_INVALID_PARAMETER);
 
-	prop = _ail_convert_to_prop_str(property);
+	return _filter_add_int(filter, _ail_convert_to_prop_int(property), value);
+}
+
+EXPORT_API ail_error_e ail_filter_add_int_by_id(ail_filter_h filter, ail_prop_id_e id, int value)
+{
+	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
+
+	return _filter_add_int(filter, (ail_prop_int_e)id, value);
+}
+
+static ail_error_e _filter_add_str(ail_filter_h filter, ail_prop_str_e prop, const char *value)
+{
+	struct element *c; //condition
 
 	if (prop < E_AIL_PROP_STR_MIN || prop > E_AIL_PROP_STR_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
@@ -170,6 +200,141 @@ EXPORT_API ail_error_e ail_filter_add_str(ail_filter_h filter, const char *prope
 	return AIL_ERROR_OK;
 }
 
+EXPORT_API ail_error_e ail_filter_add_str(ail_filter_h filter, const char *property, const char *value)
+{
+	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
+	retv_if (NULL == property, AIL_ERROR_INVALID_PARAMETER);
+
+	return _filter_add_str(filter, _ail_convert_to_prop_str(property), value);
+}
+
+EXPORT_API ail_error_e ail_filter_add_str_by_id(ail_filter_h filter, ail_prop_id_e id, const char *value)
+{
+	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
+
+	return _filter_add_str(filter, (ail_prop_str_e)id, value);
+}
+
+ail_filter_h filter_dup(ail_filter_h filter)
+{
+	struct element *e;
+	ail_filter_h copy;
+	ail_error_e ret = AIL_ERROR_OK;
+	GSList *l;
+	int t;
+
+	retv_if(!filter, NULL);
+	retv_if(ail_filter_new(&copy) != AIL_ERROR_OK, NULL);
+
+	for (l = filter->list; l && ret == AIL_ERROR_OK; l = g_slist_next(l)) {
+		e = l->data;
+		ELEMENT_TYPE(e, t);
+		switch (t) {
+			case VAL_TYPE_BOOL:
+				ret = _filter_add_bool(copy, e->prop, ELEMENT_BOOL(e)->value);
+				break;
+			case VAL_TYPE_INT:
+				ret = _filter_add_int(copy, e->prop, ELEMENT_INT(e)->value);
+				break;
+			case VAL_TYPE_STR:
+				ret = _filter_add_str(copy, e->prop, ELEMENT_STR(e)->value);
+				break;
+			default:
+				ret = AIL_ERROR_FAIL;
+		}
+	}
+
+	if (ret == AIL_ERROR_OK && filter->search && !(copy->search = strdup(filter->search)))
+		ret = AIL_ERROR_OUT_OF_MEMORY;
+
+	if (ret != AIL_ERROR_OK) {
+		ail_filter_destroy(copy);
+		return NULL;
+	}
+
+	return copy;
+}
+
+EXPORT_API ail_error_e ail_filter_add_search(ail_filter_h filter, const char *query)
+{
+	GString *terms;
+	const char *p;
+	bool in_word = false;
+
+	retv_if (NULL == filter, AIL_ERROR_INVALID_PARAMETER);
+	retv_if (NULL == query, AIL_ERROR_INVALID_PARAMETER);
+
+	/* Keep the words the FTS tokenizer keeps, so nothing else reaches the query */
+	terms = g_string_new(NULL);
+	retv_if (NULL == terms, AIL_ERROR_OUT_OF_MEMORY);
+
+	for (p = query; *p; p++) {
+		if (g_ascii_isalnum(*p) || (unsigned char)*p >= 0x80) {
+			if (!in_word && terms->len)
+				g_string_append_c(terms, ' ');
+			g_string_append_c(terms, g_ascii_tolower(*p));
+			in_word = true;
+		} else
+			in_word = false;
+	}
+
+	if (!terms->len) {
+		g_string_free(terms, TRUE);
+		return AIL_ERROR_INVALID_PARAMETER;
+	}
+
+	SAFE_FREE(filter->search);
+	filter->search = g_string_free(terms, FALSE);
+
+	return AIL_ERROR_OK;
+}
+
+/* "foo bar" -> "(... like '% foo%' and ... like '% bar%')" */
+static char *_get_search_like_condition(const char *search)
+{
+	GString *cond;
+	gchar **words;
+	int i;
+
+	words = g_strsplit(search, " ", 0);
+	retv_if(!words, NULL);
+
+	cond = g_string_new("(");
+	for (i = 0; words[i]; i++) {
+		if (i)
+			g_string_append(cond, " and ");
+		g_string_append_printf(cond, SQL_FLT_SEARCH_LIKE, words[i]);
+	}
+	g_string_append_c(cond, ')');
+	g_strfreev(words);
+
+	return g_string_free(cond, FALSE);
+}
+
+static char *_get_search_condition(const char *search, const char *locale)
+{
+	char match[AIL_SQL_QUERY_MAX_LEN / 4];
+	char buf[AIL_SQL_QUERY_MAX_LEN];
+	const char *p;
+	int i = 0;
+
+	if (!db_has_name_index())
+		return _get_search_like_condition(search);
+
+	/* "foo bar" -> "foo* bar*", a prefix query for every word */
+	for (p = search; *p && i < (int)sizeof(match) - 3; p++) {
+		if (*p == ' ')
+			match[i++] = '*';
+		match[i++] = *p;
+	}
+	match[i++] = '*';
+	match[i] = '\0';
+
+	snprintf(buf, sizeof(buf), SQL_FLT_SEARCH, match, locale, match);
+
+	return strdup(buf);
+}
+
 static void _get_condition(gpointer data, char **condition)
 {
 	struct element *e = (struct element *)data;
@@ -205,7 +370,7 @@ static void _get_condition(gpointer data, char **condition)
 	return;
 }
 
-char *_get_where_clause(ail_filter_h filter)
+char *_get_where_clause(ail_filter_h filter, const char *locale)
 {
 	char *c;
 	char w[AIL_SQL_QUERY_MAX_LEN] = {0,};
@@ -227,18 +392,27 @@ char *_get_where_clause(ail_filter_h filter)
 		w[sizeof(w)-1] = '\0';
 		if(c) free(c);
 
-		if (g_slist_next(l)) {
+		if (g_slist_next(l) || filter->search) {
 			strncat(w, " and ", sizeof(w)-strlen(w)-1);
 			w[sizeof(w)-1] = '\0';
 		}
 	}
 
+	if (filter->search) {
+		c = _get_search_condition(filter->search, locale);
+		if (!c) return NULL;
+
+		strncat(w, c, sizeof(w)-strlen(w)-1);
+		w[sizeof(w)-1] = '\0';
+		free(c);
+	}
+
 	_D("where = %s", w);
 
 	return strdup(w);
 }
 
-EXPORT_API ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *cnt)
+static ail_error_e _count_appinfo(ail_filter_h filter, int *cnt)
 {
 	char q[AIL_SQL_QUERY_MAX_LEN];
 	char *w;
@@ -250,6 +424,13 @@ EXPORT_API ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *cnt)
 
 	retv_if(!cnt, AIL_ERROR_INVALID_PARAMETER);
 
+	/* The snapshot has no name index, searches go to the DB */
+	if (!filter || !filter->search) {
+		r = snapshot_count(filter ? filter->list : NULL, cnt);
+		if (r != AIL_ERROR_FAIL)
+			return r;
+	}
+
 	if (db_open(DB_OPEN_RO) != AIL_ERROR_OK)
 		return AIL_ERROR_DB_FAILED;
 
@@ -264,16 +445,17 @@ EXPORT_API ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *cnt)
 		return AIL_ERROR_FAIL;
 	}
 	snprintf(q, sizeof(q), tmp_q, l);
-	free(l);
 	free(tmp_q);
 
-	if (filter && filter->list) { 
-		w = _get_where_clause(filter);
+	if (filter && (filter->list || filter->search)) {
+		w = _get_where_clause(filter, l);
+		free(l);
 		retv_if (NULL == w, AIL_ERROR_FAIL);
 		strncat(q, w, sizeof(q)-strlen(q)-1);
 		q[sizeof(q)-1] = '\0';
 		free(w);
-	}
+	} else
+		free(l);
 
 	_D("Query = %s",q);
 
@@ -294,18 +476,25 @@ EXPORT_API ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *cnt)
 
 
 
-EXPORT_API ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter, ail_list_appinfo_cb cb, void *user_data)
+static ail_error_e _list_appinfo_foreach(ail_filter_h filter, ail_list_appinfo_cb cb, void *user_data)
 {
 	char q[AIL_SQL_QUERY_MAX_LEN];
 	char *tmp_q;
 	char *w;
 	char *l;
 	ail_cb_ret_e r;
+	ail_error_e ret;
 	sqlite3_stmt *stmt;
 	ail_appinfo_h ai;
 
 	retv_if (NULL == cb, AIL_ERROR_INVALID_PARAMETER);
 
+	if (!filter || !filter->search) {
+		ret = snapshot_foreach(filter ? filter->list : NULL, cb, user_data);
+		if (ret != AIL_ERROR_FAIL)
+			return ret;
+	}
+
 	if (db_open(DB_OPEN_RO) != AIL_ERROR_OK)
 		return AIL_ERROR_DB_FAILED;
 
@@ -320,20 +509,28 @@ EXPORT_API ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter, ail_
 		return AIL_ERROR_FAIL;
 	}
 	snprintf(q, sizeof(q), tmp_q, l);
-	free(l);
 	free(tmp_q);
 
-	if (filter && filter->list) {
-		w = _get_where_clause(filter);
+	if (filter && (filter->list || filter->search)) {
+		w = _get_where_clause(filter, l);
+		free(l);
 		retv_if (NULL == w, AIL_ERROR_FAIL);
 		strncat(q, w, sizeof(q)-strlen(q)-1);
 		q[sizeof(q)-1] = '\0';
-		strncat(q, " order by app_info.package", sizeof(q)-strlen(q)-1);
-		q[sizeof(q)-1] = '\0';
 		free(w);
+
+		if (filter->search) {
+			char order[AIL_SQL_QUERY_MAX_LEN];
+			snprintf(order, sizeof(order), SQL_ORD_SEARCH, filter->search, filter->search);
+			strncat(q, order, sizeof(q)-strlen(q)-1);
+		} else
+			strncat(q, " order by app_info.package", sizeof(q)-strlen(q)-1);
+		q[sizeof(q)-1] = '\0';
 	}
-	else
+	else {
+		free(l);
 		_D("No filter exists. All records are retreived");
+	}
 
 	_D("Query = %s",q);
 
@@ -345,7 +542,7 @@ EXPORT_API ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter, ail_
 
 	appinfo_set_stmt(ai, stmt);
 	while (db_step(stmt) == AIL_ERROR_OK) {
-
+		appinfo_next_row(ai);
 		r = cb(ai, user_data);
 		if (AIL_CB_RET_CANCEL == r)
 			break;
@@ -357,3 +554,332 @@ EXPORT_API ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter, ail_
 	return AIL_ERROR_OK;
 }
 
+
+static void _record_filter(struct record *rec, ail_filter_h filter)
+{
+	struct element *e;
+	GSList *l;
+	int t;
+
+	if (!filter)
+		return;
+
+	for (l = filter->list; l; l = g_slist_next(l)) {
+		e = l->data;
+		ELEMENT_TYPE(e, t);
+		switch (t) {
+			case VAL_TYPE_BOOL:
+				record_arg_byte(rec, RECORD_FILTER_BOOL);
+				record_arg_byte(rec, e->prop);
+				record_arg_byte(rec, ELEMENT_BOOL(e)->value);
+				break;
+			case VAL_TYPE_INT:
+				record_arg_byte(rec, RECORD_FILTER_INT);
+				record_arg_byte(rec, e->prop);
+				record_arg_int(rec, ELEMENT_INT(e)->value);
+				break;
+			case VAL_TYPE_STR:
+				record_arg_byte(rec, RECORD_FILTER_STR);
+				record_arg_byte(rec, e->prop);
+				record_arg_str(rec, ELEMENT_STR(e)->value);
+				break;
+		}
+	}
+
+	if (filter->search) {
+		record_arg_byte(rec, RECORD_FILTER_SEARCH);
+		record_arg_str(rec, filter->search);
+	}
+}
+
+EXPORT_API ail_error_e ail_filter_count_appinfo(ail_filter_h filter, int *cnt)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	recording = record_begin(&rec);
+	ret = _count_appinfo(filter, cnt);
+	if (recording) {
+		_record_filter(&rec, filter);
+		record_end(&rec, RECORD_FILTER_COUNT, ret);
+	}
+
+	return ret;
+}
+
+EXPORT_API ail_error_e ail_filter_list_appinfo_foreach(ail_filter_h filter, ail_list_appinfo_cb cb, void *user_data)
+{
+	struct record_rows rows = { .cb = cb, .user_data = user_data, };
+	struct record rec;
+	ail_error_e ret;
+
+	retv_if (NULL == cb, AIL_ERROR_INVALID_PARAMETER);
+
+	if (!record_begin(&rec))
+		return _list_appinfo_foreach(filter, cb, user_data);
+
+	ret = _list_appinfo_foreach(filter, record_rows_cb, &rows);
+	record_arg_int(&rec, rows.rows);
+	_record_filter(&rec, filter);
+	record_end(&rec, RECORD_FILTER_FOREACH, ret);
+
+	return ret;
+}
+
+
+/* Calls cb for the rows of packages[0..n) matching the filter, all of them if packages is NULL */
+static ail_error_e _watch_query(struct ail_filter_watch *w, const char **packages, int n,
+		GHashTable *seen, bool notify)
+{
+	char q[AIL_SQL_QUERY_MAX_LEN];
+	char *tmp_q;
+	char *wc;
+	char *l;
+	const char *package;
+	ail_filter_match_e match;
+	ail_appinfo_h ai;
+	sqlite3_stmt *stmt;
+	ail_error_e ret;
+	int i;
+
+	snprintf(q, sizeof(q), "SELECT %s FROM %s", SQL_FLD_APP_INFO_WITH_LOCALNAME, SQL_TBL_APP_INFO_WITH_LOCALNAME);
+
+	tmp_q = strdup(q);
+	retv_if (NULL == tmp_q, AIL_ERROR_OUT_OF_MEMORY);
+	l = sql_get_locale();
+	if (NULL == l) {
+		_E("Failed to get locale string");
+		free(tmp_q);
+		return AIL_ERROR_FAIL;
+	}
+	snprintf(q, sizeof(q), tmp_q, l);
+	free(tmp_q);
+
+	if (w->filter->list || w->filter->search) {
+		wc = _get_where_clause(w->filter, l);
+		free(l);
+		retv_if (NULL == wc, AIL_ERROR_FAIL);
+		strncat(q, wc, sizeof(q)-strlen(q)-1);
+		free(wc);
+	} else {
+		free(l);
+		strncat(q, " WHERE 1", sizeof(q)-strlen(q)-1);
+	}
+
+	if (packages) {
+		strncat(q, " and app_info.package in (?", sizeof(q)-strlen(q)-1);
+		for (i = 1; i < n; i++)
+			strncat(q, ",?", sizeof(q)-strlen(q)-1);
+		strncat(q, ")", sizeof(q)-strlen(q)-1);
+	}
+	q[sizeof(q)-1] = '\0';
+
+	_D("Query = %s",q);
+
+	if (db_prepare(q, &stmt) != AIL_ERROR_OK)
+		return AIL_ERROR_DB_FAILED;
+
+	for (i = 0; packages && i < n; i++) {
+		if (db_bind_str(stmt, i + 1, packages[i]) != AIL_ERROR_OK) {
+			db_finalize(stmt);
+			return AIL_ERROR_DB_FAILED;
+		}
+	}
+
+	ai = appinfo_create();
+	appinfo_set_stmt(ai, stmt);
+
+	while ((ret = db_step(stmt)) == AIL_ERROR_OK) {
+		package = (const char *)sqlite3_column_text(stmt, 0);
+		if (!package || g_hash_table_contains(seen, package))
+			continue;
+
+		g_hash_table_add(seen, g_strdup(package));
+
+		match = g_hash_table_contains(w->matches, package) ?
+			AIL_FILTER_MATCH_MODIFIED : AIL_FILTER_MATCH_ADDED;
+		if (match == AIL_FILTER_MATCH_ADDED)
+			g_hash_table_add(w->matches, g_strdup(package));
+
+		if (notify) {
+			appinfo_next_row(ai);
+			w->cb(match, package, ai, w->user_data);
+			if (w->dead)
+				break;
+		}
+	}
+
+	appinfo_destroy(ai);
+	db_finalize(stmt);
+
+	return (ret == AIL_ERROR_NO_DATA || ret == AIL_ERROR_OK) ? AIL_ERROR_OK : ret;
+}
+
+
+
+/* Re-evaluates the filter for packages, or for every row if packages is NULL */
+static ail_error_e _watch_evaluate(struct ail_filter_watch *w, GPtrArray *packages, bool notify)
+{
+	GHashTable *seen;
+	GHashTableIter iter;
+	GPtrArray *removed;
+	gpointer package;
+	ail_error_e ret = AIL_ERROR_OK;
+	int i;
+
+	retv_if(db_open(DB_OPEN_RO) != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
+
+	seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	if (!packages)
+		ret = _watch_query(w, NULL, 0, seen, notify);
+
+	for (i = 0; packages && ret == AIL_ERROR_OK && !w->dead && i < packages->len; i += WATCH_CHUNK) {
+		ret = _watch_query(w, (const char **)packages->pdata + i,
+				MIN(WATCH_CHUNK, packages->len - i), seen, notify);
+	}
+
+	if (ret != AIL_ERROR_OK || w->dead) {
+		g_hash_table_destroy(seen);
+		return ret;
+	}
+
+	/* Matched before, not anymore */
+	removed = g_ptr_array_new();
+	if (packages) {
+		for (i = 0; i < packages->len; i++) {
+			if (!g_hash_table_contains(seen, packages->pdata[i]) &&
+					g_hash_table_contains(w->matches, packages->pdata[i]))
+				g_ptr_array_add(removed, packages->pdata[i]);
+		}
+	} else {
+		g_hash_table_iter_init(&iter, w->matches);
+		while (g_hash_table_iter_next(&iter, &package, NULL)) {
+			if (!g_hash_table_contains(seen, package))
+				g_ptr_array_add(removed, package);
+		}
+	}
+
+	for (i = 0; i < removed->len && !w->dead; i++) {
+		package = g_strdup(removed->pdata[i]);
+		g_hash_table_remove(w->matches, package);
+		if (notify)
+			w->cb(AIL_FILTER_MATCH_REMOVED, package, NULL, w->user_data);
+		g_free(package);
+	}
+
+	g_ptr_array_free(removed, TRUE);
+	g_hash_table_destroy(seen);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static void _watch_free(struct ail_filter_watch *w)
+{
+	if (w->filter)
+		ail_filter_destroy(w->filter);
+	g_hash_table_destroy(w->matches);
+	free(w);
+}
+
+
+
+static void _watch_changes_cb(const ail_change_s *changes, int count, void *user_data)
+{
+	struct ail_filter_watch *w = user_data;
+	GHashTable *unique;
+	GPtrArray *packages = NULL;
+	int i;
+
+	if (changes) {
+		unique = g_hash_table_new(g_str_hash, g_str_equal);
+		packages = g_ptr_array_new();
+		for (i = 0; i < count; i++) {
+			if (g_hash_table_contains(unique, changes[i].package))
+				continue;
+			g_hash_table_add(unique, (gpointer)changes[i].package);
+			g_ptr_array_add(packages, (gpointer)changes[i].package);
+		}
+		g_hash_table_destroy(unique);
+	}
+
+	/* Lost changes, compare with every row instead */
+	w->busy = true;
+	if (_watch_evaluate(w, packages, true) != AIL_ERROR_OK)
+		_E("Cannot evaluate the watched filter");
+	w->busy = false;
+
+	if (packages)
+		g_ptr_array_free(packages, TRUE);
+
+	if (w->dead)
+		_watch_free(w);
+}
+
+
+
+EXPORT_API ail_error_e ail_filter_watch(ail_filter_h filter, ail_filter_watch_cb cb, void *user_data,
+		ail_filter_watch_h *watch)
+{
+	struct ail_filter_watch *w;
+	ail_error_e ret;
+
+	retv_if(!filter, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!watch, AIL_ERROR_INVALID_PARAMETER);
+
+	w = calloc(1, sizeof(struct ail_filter_watch));
+	retv_if(!w, AIL_ERROR_OUT_OF_MEMORY);
+
+	w->cb = cb;
+	w->user_data = user_data;
+	w->matches = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+	/* The caller may destroy its filter right away */
+	w->filter = filter_dup(filter);
+	if (!w->filter) {
+		_watch_free(w);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	/* Subscribe first, a change committed meanwhile is delivered again */
+	ret = ail_changes_subscribe(0, _watch_changes_cb, w, &w->sub);
+	if (ret == AIL_ERROR_OK) {
+		ret = _watch_evaluate(w, NULL, false);
+		if (ret != AIL_ERROR_OK)
+			ail_changes_unsubscribe(w->sub);
+	}
+
+	if (ret != AIL_ERROR_OK) {
+		_watch_free(w);
+		return ret;
+	}
+
+	*watch = w;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_filter_unwatch(ail_filter_watch_h watch)
+{
+	retv_if(!watch, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(watch->dead, AIL_ERROR_INVALID_PARAMETER);
+
+	ail_changes_unsubscribe(watch->sub);
+
+	if (watch->busy) {
+		/* Freed once the callback returns */
+		watch->dead = true;
+		return AIL_ERROR_OK;
+	}
+
+	_watch_free(watch);
+
+	return AIL_ERROR_OK;
+}
+
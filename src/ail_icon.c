@@ -0,0 +1,349 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <glib.h>
+#include <vconf.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_db.h"
+#include "ail_icon.h"
+#include "ail_trace.h"
+
+#define ICON_THEME_KEY "db/setting/theme"
+#define ICON_DEFAULT_THEME "default"
+#define ICON_DEFAULT_SIZE "small"
+
+/* Paths kept, all of them are dropped past it */
+#define ICON_PATHS_MAX 4096
+
+/* Icon paths resolved from the names the DB keeps, until the theme or the installed apps change */
+static struct {
+	pthread_mutex_t lock;
+	bool watching;
+	unsigned long long generation;
+	char *theme;		/* current theme, read at the first lookup */
+	GHashTable *paths;	/* "<theme>/<size>/<icon>" -> path */
+	GHashTable *dirs;	/* shared icon directory -> set of its file names, NULL if it cannot be read */
+} icons = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+
+
+static void _destroy_names(gpointer data)
+{
+	if (data)
+		g_hash_table_destroy(data);
+}
+
+
+
+/* Called with icons.lock held */
+static void _flush(void)
+{
+	if (icons.paths)
+		g_hash_table_remove_all(icons.paths);
+	if (icons.dirs)
+		g_hash_table_remove_all(icons.dirs);
+	SAFE_FREE(icons.theme);
+	icons.theme = NULL;
+}
+
+
+
+static void _theme_cb(keynode_t *node, void *user_data)
+{
+	pthread_mutex_lock(&icons.lock);
+	_flush();
+	pthread_mutex_unlock(&icons.lock);
+}
+
+
+
+/* Called with icons.lock held */
+static bool _validate(void)
+{
+	unsigned long long generation;
+
+	if (!icons.paths) {
+		icons.paths = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+		icons.dirs = g_hash_table_new_full(g_str_hash, g_str_equal, free, _destroy_names);
+		retv_if(!icons.paths || !icons.dirs, false);
+	}
+
+	if (!icons.watching) {
+		if (vconf_notify_key_changed(ICON_THEME_KEY, _theme_cb, NULL) < 0)
+			_E("Cannot watch %s, icons follow the theme on the next DB change", ICON_THEME_KEY);
+		icons.watching = true;
+	}
+
+	/* Icons come and go with apps, and the theme is read again */
+	if (db_read_generation(&generation) && generation != icons.generation) {
+		_flush();
+		icons.generation = generation;
+	}
+
+	return true;
+}
+
+
+
+/* Called with icons.lock held */
+static GHashTable *_dir(const char *dir)
+{
+	GHashTable *names = NULL;
+	gpointer value;
+	struct dirent *entry;
+	DIR *dp;
+	char *name;
+
+	if (g_hash_table_lookup_extended(icons.dirs, dir, NULL, &value))
+		return value;
+
+	dp = opendir(dir);
+	if (dp) {
+		names = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+		while (names && (entry = readdir(dp))) {
+			if (entry->d_name[0] == '.')
+				continue;
+			name = strdup(entry->d_name);
+			if (name)
+				g_hash_table_add(names, name);
+		}
+		closedir(dp);
+	}
+
+	name = strdup(dir);
+	if (!name) {
+		_destroy_names(names);
+		return NULL;
+	}
+	g_hash_table_insert(icons.dirs, name, names);
+
+	return names;
+}
+
+
+
+/* Looks path up in the names of its directory read once, unless probe */
+static bool _shared_exists(const char *path, bool probe)
+{
+	char dir[PATH_MAX];
+	GHashTable *names;
+	const char *slash;
+
+	slash = rindex(path, '/');
+	if (probe || !slash || slash - path >= (int)sizeof(dir))
+		return access(path, R_OK) == 0;
+
+	snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path), path);
+	names = _dir(dir);
+
+	return names && g_hash_table_contains(names, slash + 1);
+}
+
+
+
+static char *_package(const char *icon)
+{
+	char *package;
+	char *extension;
+
+	package = strdup(icon);
+	retv_if(!package, NULL);
+
+	extension = rindex(package, '.');
+	if (extension) {
+		*extension = '\0';
+	} else {
+		_E("cannot extract from icon [%s] to package.", icon);
+	}
+
+	return package;
+}
+
+
+
+/* Leaves the last place looked at in path if there is no such icon */
+static bool _find(char *path, int len, const char *package, const char *theme,
+		const char *size, const char *icon, bool probe)
+{
+	snprintf(path, len, AIL_ROOT"/opt/share/icons/%s/%s/%s", theme, size, icon);
+	if (_shared_exists(path, probe)) return true;
+	snprintf(path, len, AIL_ROOT"/usr/share/icons/%s/%s/%s", theme, size, icon);
+	if (_shared_exists(path, probe)) return true;
+	_D("cannot find icon %s", path);
+	snprintf(path, len, AIL_ROOT"/opt/share/icons/"ICON_DEFAULT_THEME"/%s/%s", size, icon);
+	if (_shared_exists(path, probe)) return true;
+	snprintf(path, len, AIL_ROOT"/usr/share/icons/"ICON_DEFAULT_THEME"/%s/%s", size, icon);
+	if (_shared_exists(path, probe)) return true;
+
+	#if 1 /* this will be remove when finish the work for moving icon path */
+	if (!probe)
+		_E("icon file must be moved to %s", path);
+	snprintf(path, len, AIL_ROOT"/opt/apps/%s/res/icons/%s/%s/%s", package, theme, size, icon);
+	if (access(path, R_OK) == 0) return true;
+	snprintf(path, len, AIL_ROOT"/usr/apps/%s/res/icons/%s/%s/%s", package, theme, size, icon);
+	if (access(path, R_OK) == 0) return true;
+	_D("cannot find icon %s", path);
+	snprintf(path, len, AIL_ROOT"/opt/apps/%s/res/icons/"ICON_DEFAULT_THEME"/%s/%s", package, size, icon);
+	if (access(path, R_OK) == 0) return true;
+	snprintf(path, len, AIL_ROOT"/usr/apps/%s/res/icons/"ICON_DEFAULT_THEME"/%s/%s", package, size, icon);
+	if (access(path, R_OK) == 0) return true;
+	#endif
+
+	return false;
+}
+
+
+
+/* Called with icons.lock held */
+static char *_resolve(const char *icon, const char *theme, const char *size)
+{
+	char *package;
+	char *path;
+	int len;
+
+	package = _package(icon);
+	retv_if(!package, NULL);
+
+	len = (0x01 << 7) + strlen(AIL_ROOT) + strlen(icon) + strlen(package) + strlen(theme) + strlen(size);
+	path = calloc(1, len);
+	if (!path) {
+		_E("(path == NULL) return\n");
+		free(package);
+		return NULL;
+	}
+
+	/* An icon installed since its directory was read is still found */
+	if (!_find(path, len, package, theme, size, icon, false))
+		_find(path, len, package, theme, size, icon, true);
+
+	free(package);
+
+	_D("Icon path : %s ---> %s", icon, path);
+
+	return path;
+}
+
+
+
+/* The path of icon for theme and size, NULL for the current theme and the small icons */
+char *icon_resolve(const char *icon, const char *theme, const char *size)
+{
+	char key[PATH_MAX];
+	char *path;
+	char *copy;
+
+	retv_if(!icon, NULL);
+
+	/* Given with its path in the desktop file */
+	if (index(icon, '/'))
+		return strdup(icon);
+
+	if (!size)
+		size = ICON_DEFAULT_SIZE;
+
+	pthread_mutex_lock(&icons.lock);
+
+	if (!_validate()) {
+		pthread_mutex_unlock(&icons.lock);
+		return NULL;
+	}
+
+	if (!theme) {
+		if (!icons.theme)
+			icons.theme = vconf_get_str(ICON_THEME_KEY);
+		theme = (icons.theme && *icons.theme) ? icons.theme : ICON_DEFAULT_THEME;
+	}
+
+	snprintf(key, sizeof(key), "%s/%s/%s", theme, size, icon);
+	path = g_hash_table_lookup(icons.paths, key);
+	if (path) {
+		path = strdup(path);
+		pthread_mutex_unlock(&icons.lock);
+		return path;
+	}
+
+	TRACE_BEGIN(AIL_TRACE_ICON_RESOLVE, icon);
+	path = _resolve(icon, theme, size);
+	TRACE_END(AIL_TRACE_ICON_RESOLVE, icon);
+
+	if (path && (copy = strdup(path))) {
+		if (g_hash_table_size(icons.paths) >= ICON_PATHS_MAX)
+			g_hash_table_remove_all(icons.paths);
+		g_hash_table_insert(icons.paths, strdup(key), copy);
+	}
+
+	pthread_mutex_unlock(&icons.lock);
+
+	return path;
+}
+
+
+
+/* The icon name of a path resolved and stored by an older version, NULL if path is not one */
+char *icon_name(const char *path)
+{
+	char pattern[PATH_MAX];
+	const char *name;
+	char *package;
+	bool resolved;
+
+	retv_if(!path, NULL);
+
+	name = rindex(path, '/');
+	retv_if(!name, NULL);
+	name++;
+
+	package = _package(name);
+	retv_if(!package, NULL);
+
+	snprintf(pattern, sizeof(pattern), AIL_ROOT"/opt/share/icons/*/*/%s", name);
+	resolved = !fnmatch(pattern, path, FNM_PATHNAME);
+	snprintf(pattern, sizeof(pattern), AIL_ROOT"/usr/share/icons/*/*/%s", name);
+	resolved = resolved || !fnmatch(pattern, path, FNM_PATHNAME);
+	snprintf(pattern, sizeof(pattern), AIL_ROOT"/opt/apps/%s/res/icons/*/*/%s", package, name);
+	resolved = resolved || !fnmatch(pattern, path, FNM_PATHNAME);
+	snprintf(pattern, sizeof(pattern), AIL_ROOT"/usr/apps/%s/res/icons/*/*/%s", package, name);
+	resolved = resolved || !fnmatch(pattern, path, FNM_PATHNAME);
+
+	free(package);
+
+	return resolved ? strdup(name) : NULL;
+}
+
+
+// End of file.
@@ -0,0 +1,210 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <xdgmime.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_sql.h"
+#include "ail_db.h"
+#include "ail_package.h"
+#include "ail_trace.h"
+#include "ail_record.h"
+
+#define MIME_TYPES_MAX	16
+
+struct mime_types {
+	char *type[MIME_TYPES_MAX];
+	int n;
+};
+
+static void _add_type(struct mime_types *t, const char *type)
+{
+	const char *unalias;
+	int i;
+
+	if (!type || t->n >= MIME_TYPES_MAX)
+		return;
+
+	TRACE_BEGIN(AIL_TRACE_MIME_UNALIAS, type);
+	unalias = xdg_mime_unalias_mime_type(type);
+	TRACE_END(AIL_TRACE_MIME_UNALIAS, type);
+	if (unalias)
+		type = unalias;
+
+	for (i = 0; i < t->n; i++) {
+		if (!strcasecmp(t->type[i], type))
+			return;
+	}
+
+	t->type[t->n] = strdup(type);
+	if (t->type[t->n])
+		t->n++;
+}
+
+
+
+/* The type itself, its ancestors nearest first, then the implicit parents */
+static void _get_types(const char *mime, struct mime_types *t)
+{
+	char **parents;
+	char buf[256];
+	const char *slash;
+	int i, j;
+
+	_add_type(t, mime);
+
+	for (i = 0; i < t->n; i++) {
+		parents = xdg_mime_list_mime_parents(t->type[i]);
+		if (!parents)
+			continue;
+		for (j = 0; parents[j]; j++)
+			_add_type(t, parents[j]);
+		free(parents);
+	}
+
+	if (!strncasecmp(mime, "text/", 5))
+		_add_type(t, "text/plain");
+
+	slash = strchr(mime, '/');
+	if (slash) {
+		snprintf(buf, sizeof(buf), "%.*s/*", (int)(slash - mime), mime);
+		_add_type(t, buf);
+	}
+
+	if (strncasecmp(mime, "inode/", 6))
+		_add_type(t, "application/octet-stream");
+}
+
+
+
+static ail_error_e _get_handlers(const char *mime, ail_list_appinfo_cb cb, void *user_data)
+{
+	struct mime_types t = { .n = 0, };
+	char q[AIL_SQL_QUERY_MAX_LEN];
+	char tbl[AIL_SQL_QUERY_MAX_LEN];
+	char in[AIL_SQL_QUERY_MAX_LEN / 4] = {0,};
+	char rank[AIL_SQL_QUERY_MAX_LEN / 2] = {0,};
+	char *l;
+	int i;
+	ail_error_e ret;
+	sqlite3_stmt *stmt;
+	ail_appinfo_h ai;
+
+	retv_if(!mime, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+
+	_get_types(mime, &t);
+	retv_if(!t.n, AIL_ERROR_OUT_OF_MEMORY);
+
+	for (i = 0; i < t.n; i++) {
+		snprintf(in + strlen(in), sizeof(in) - strlen(in), "%s?%d", i ? "," : "", i + 1);
+		snprintf(rank + strlen(rank), sizeof(rank) - strlen(rank), " when ?%d then %d", i + 1, i);
+	}
+
+	l = sql_get_locale();
+	if (NULL == l) {
+		_E("Failed to get locale string");
+		ret = AIL_ERROR_FAIL;
+		goto out;
+	}
+	snprintf(tbl, sizeof(tbl), SQL_TBL_APP_INFO_WITH_LOCALNAME, l);
+	free(l);
+
+	/* app_token holds one row per declared type, so each type is an index lookup */
+	snprintf(q, sizeof(q), "SELECT %s FROM %s "
+			"JOIN (SELECT package, min(case value COLLATE NOCASE%s end) AS rank "
+			"FROM app_token WHERE field='mimetype' AND value COLLATE NOCASE IN (%s) "
+			"GROUP BY package) AS handler "
+			"ON handler.package=app_info.package "
+			"order by handler.rank, app_info.package",
+			SQL_FLD_APP_INFO_WITH_LOCALNAME, tbl, rank, in);
+
+	_D("Query = %s", q);
+
+	ret = db_open(DB_OPEN_RO);
+	if (ret != AIL_ERROR_OK)
+		goto out;
+
+	ret = db_prepare(q, &stmt);
+	if (ret != AIL_ERROR_OK)
+		goto out;
+
+	for (i = 0; i < t.n && ret == AIL_ERROR_OK; i++)
+		ret = db_bind_str(stmt, i + 1, t.type[i]);
+
+	if (ret != AIL_ERROR_OK) {
+		db_finalize(stmt);
+		goto out;
+	}
+
+	ai = appinfo_create();
+	if (!ai) {
+		db_finalize(stmt);
+		ret = AIL_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	appinfo_set_stmt(ai, stmt);
+	while (db_step(stmt) == AIL_ERROR_OK) {
+		appinfo_next_row(ai);
+		if (cb(ai, user_data) == AIL_CB_RET_CANCEL)
+			break;
+	}
+	appinfo_destroy(ai);
+
+	db_finalize(stmt);
+
+out:
+	for (i = 0; i < t.n; i++)
+		free(t.type[i]);
+
+	return ret;
+}
+
+
+
+EXPORT_API ail_error_e ail_mime_get_handlers(const char *mime, ail_list_appinfo_cb cb, void *user_data)
+{
+	struct record_rows rows = { .cb = cb, .user_data = user_data, };
+	struct record rec;
+	ail_error_e ret;
+
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+
+	if (!record_begin(&rec))
+		return _get_handlers(mime, cb, user_data);
+
+	ret = _get_handlers(mime, record_rows_cb, &rows);
+	record_arg_int(&rec, rows.rows);
+	record_arg_str(&rec, mime);
+	record_end(&rec, RECORD_MIME_GET_HANDLERS, ret);
+
+	return ret;
+}
+
+
+
+// End of file
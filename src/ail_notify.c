@@ -0,0 +1,168 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+#include <vconf.h>
+#include "ail.h"
+#include "ail_private.h"
+
+struct ail_changes_subscription {
+	int interval;
+	ail_changes_cb cb;
+	void *user_data;
+	unsigned long long seq;		/* last change delivered */
+	guint timer;
+};
+
+/* Subscriptions of the main loop, one vconf watch for all of them */
+static GSList *subscriptions;
+
+
+
+static ail_cb_ret_e _collect(unsigned long long seq, ail_change_type_e type,
+		const char *package, void *user_data)
+{
+	GArray *changes = user_data;
+	ail_change_s change;
+
+	change.seq = seq;
+	change.type = type;
+	change.package = g_strdup(package);
+	g_array_append_val(changes, change);
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+static gboolean _flush(gpointer data)
+{
+	struct ail_changes_subscription *sub = data;
+	ail_changes_cb cb = sub->cb;
+	void *user_data = sub->user_data;
+	GArray *changes;
+	ail_error_e ret;
+	int i;
+
+	sub->timer = 0;
+
+	changes = g_array_new(FALSE, FALSE, sizeof(ail_change_s));
+
+	ret = ail_changes_since(sub->seq, _collect, changes);
+	if (ret == AIL_ERROR_EXPIRED) {
+		_E("Changes after %llu are gone, the subscriber has to reload", sub->seq);
+		if (ail_changes_get_latest(&sub->seq) == AIL_ERROR_OK)
+			cb(NULL, 0, user_data);
+	} else if (ret != AIL_ERROR_OK) {
+		_E("Cannot read the changes after %llu", sub->seq);
+	} else if (changes->len) {
+		/* Last use of sub, the callback may unsubscribe */
+		sub->seq = g_array_index(changes, ail_change_s, changes->len - 1).seq;
+		cb((const ail_change_s *)changes->data, changes->len, user_data);
+	}
+
+	for (i = 0; i < changes->len; i++)
+		g_free((char *)g_array_index(changes, ail_change_s, i).package);
+	g_array_free(changes, TRUE);
+
+	return FALSE;
+}
+
+
+
+static void _noti_cb(keynode_t *node, void *user_data)
+{
+	struct ail_changes_subscription *sub;
+	GSList *l;
+
+	/* Not restarted, a steady stream is still delivered every interval ms */
+	for (l = subscriptions; l; l = g_slist_next(l)) {
+		sub = l->data;
+		if (!sub->timer)
+			sub->timer = g_timeout_add(sub->interval, _flush, sub);
+	}
+}
+
+
+
+EXPORT_API ail_error_e ail_changes_subscribe(int interval_ms, ail_changes_cb cb, void *user_data,
+		ail_changes_subscription_h *subscription)
+{
+	struct ail_changes_subscription *sub;
+	ail_error_e ret;
+
+	retv_if(interval_ms < 0, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!subscription, AIL_ERROR_INVALID_PARAMETER);
+
+	sub = calloc(1, sizeof(struct ail_changes_subscription));
+	retv_if(!sub, AIL_ERROR_OUT_OF_MEMORY);
+
+	sub->interval = interval_ms;
+	sub->cb = cb;
+	sub->user_data = user_data;
+
+	ret = ail_changes_get_latest(&sub->seq);
+	if (ret != AIL_ERROR_OK) {
+		free(sub);
+		return ret;
+	}
+
+	if (!subscriptions && vconf_notify_key_changed(AIL_NOTI_KEY, _noti_cb, NULL) < 0) {
+		_E("Cannot watch %s", AIL_NOTI_KEY);
+		free(sub);
+		return AIL_ERROR_FAIL;
+	}
+
+	subscriptions = g_slist_prepend(subscriptions, sub);
+	*subscription = sub;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_changes_unsubscribe(ail_changes_subscription_h subscription)
+{
+	retv_if(!subscription, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!g_slist_find(subscriptions, subscription), AIL_ERROR_INVALID_PARAMETER);
+
+	subscriptions = g_slist_remove(subscriptions, subscription);
+	if (!subscriptions)
+		vconf_ignore_key_changed(AIL_NOTI_KEY, _noti_cb);
+
+	if (subscription->timer)
+		g_source_remove(subscription->timer);
+	free(subscription);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+// End of file
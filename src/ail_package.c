@@ -23,6 +23,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <glib.h>
 #include <db-util.h>
 #include <vconf.h>
 #include "ail.h"
@@ -31,11 +32,17 @@
 #include "ail_db.h"
 #include "ail_sql.h"
 #include "ail_package.h"
+#include "ail_cache.h"
+#include "ail_snapshot.h"
+#include "ail_trace.h"
+#include "ail_record.h"
+#include "ail_icon.h"
 
 
 struct ail_appinfo {
 	char **values;
 	sqlite3_stmt *stmt;
+	GSList *icons;	/* icon paths handed out, kept until the handle goes */
 };
 
 void appinfo_set_stmt(ail_appinfo_h ai, sqlite3_stmt *stmt)
@@ -43,6 +50,19 @@ void appinfo_set_stmt(ail_appinfo_h ai, sqlite3_stmt *stmt)
 	ai->stmt = stmt;
 }
 
+/* A handle reused for each row of a list drops the paths handed out for the previous row */
+void appinfo_next_row(ail_appinfo_h ai)
+{
+	g_slist_free_full(ai->icons, free);
+	ai->icons = NULL;
+}
+
+/* values[NAME] must already hold the name for the current locale */
+void appinfo_set_values(ail_appinfo_h ai, char **values)
+{
+	ai->values = values;
+}
+
 ail_appinfo_h appinfo_create(void)
 {
 	ail_appinfo_h ai;
@@ -55,8 +75,46 @@ ail_appinfo_h appinfo_create(void)
 
 void appinfo_destroy(ail_appinfo_h ai)
 {
-	if (ai) 
+	if (ai) {
+		g_slist_free_full(ai->icons, free);
 		free(ai);
+	}
+}
+
+static ail_error_e _retrieve_all_column(ail_appinfo_h ai);
+
+/* A handle owning its values, from one bound to a row or to borrowed values */
+ail_appinfo_h appinfo_detach(const ail_appinfo_h ai)
+{
+	ail_appinfo_h copy;
+	int i;
+
+	retv_if(!ai, NULL);
+
+	copy = appinfo_create();
+	retv_if(!copy, NULL);
+
+	if (ai->values) {
+		copy->values = calloc(NUM_OF_PROP, sizeof(char *));
+		for (i = 0; copy->values && i < NUM_OF_PROP; i++) {
+			if (ai->values[i] && !(copy->values[i] = strdup(ai->values[i]))) {
+				ail_destroy_appinfo(copy);
+				return NULL;
+			}
+		}
+	} else {
+		copy->stmt = ai->stmt;
+		if (_retrieve_all_column(copy) != AIL_ERROR_OK)
+			copy->values = NULL;
+		copy->stmt = NULL;
+	}
+
+	if (!copy->values) {
+		appinfo_destroy(copy);
+		return NULL;
+	}
+
+	return copy;
 }
 
 
@@ -73,6 +131,7 @@ static ail_error_e _retrieve_all_column(ail_appinfo_h ai)
 	ai->values = calloc(NUM_OF_PROP, sizeof(char *));
 	retv_if(!ai->values, AIL_ERROR_OUT_OF_MEMORY);
 
+	TRACE_BEGIN(AIL_TRACE_ROW_FILL, NULL);
 	for (i = 0; i < NUM_OF_PROP; i++) {
 		err = db_column_str(ai->stmt, i, &col);
 		if (AIL_ERROR_OK != err) 
@@ -89,6 +148,17 @@ static ail_error_e _retrieve_all_column(ail_appinfo_h ai)
 		}
 	}
 
+	if (AIL_ERROR_OK == err) {
+		err = db_column_str(ai->stmt, SQL_LOCALNAME_IDX, &col);
+		if (AIL_ERROR_OK == err && col) {
+			SAFE_FREE(ai->values[E_AIL_PROP_NAME_STR]);
+			ai->values[E_AIL_PROP_NAME_STR] = strdup(col);
+			if (!ai->values[E_AIL_PROP_NAME_STR])
+				err = AIL_ERROR_OUT_OF_MEMORY;
+		}
+	}
+	TRACE_END(AIL_TRACE_ROW_FILL, NULL);
+
 	if (err < 0) {
 		for (j = 0; j < i; ++j) {
 			if (ai->values[j])
@@ -121,28 +191,57 @@ EXPORT_API ail_error_e ail_destroy_appinfo(ail_appinfo_h ai)
 	}
 
 	free(ai->values);
+	g_slist_free_full(ai->icons, free);
 	free(ai);
 
 	return AIL_ERROR_OK;
 }
 
 
-EXPORT_API ail_error_e ail_package_get_appinfo(const char *package, ail_appinfo_h *ai)
+static ail_error_e _get_appinfo(ail_prop_str_e prop, const char *key, ail_appinfo_h *ai)
 {
 	ail_error_e ret;
 	char query[AIL_SQL_QUERY_MAX_LEN];
+	char tbl[AIL_SQL_QUERY_MAX_LEN];
 	sqlite3_stmt *stmt = NULL;
 	char w[AIL_SQL_QUERY_MAX_LEN];
-
-	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	char *locale;
+	cache_key_type type;
 
 	*ai = appinfo_create();
 	retv_if(!*ai, AIL_ERROR_OUT_OF_MEMORY);
 
-	snprintf(w, sizeof(w), sql_get_filter(E_AIL_PROP_PACKAGE_STR), package);
+	ret = snapshot_get_appinfo(prop, key, &(*ai)->values);
+	if (ret == AIL_ERROR_OK)
+		return AIL_ERROR_OK;
+	else if (ret == AIL_ERROR_NO_DATA) {
+		appinfo_destroy(*ai);
+		return AIL_ERROR_NO_DATA;
+	}
+
+	type = (E_AIL_PROP_PACKAGE_STR == prop) ? CACHE_KEY_PACKAGE : CACHE_KEY_APPID;
+	ret = cache_lookup(type, key, &(*ai)->values);
+	if (ret == AIL_ERROR_OK)
+		return AIL_ERROR_OK;
+
+	if (cache_is_absent(type, key)) {
+		appinfo_destroy(*ai);
+		return AIL_ERROR_NO_DATA;
+	}
+
+	locale = sql_get_locale();
+	if (NULL == locale) {
+		_E("Failed to get locale string");
+		appinfo_destroy(*ai);
+		return AIL_ERROR_FAIL;
+	}
 
-	snprintf(query, sizeof(query), "SELECT %s FROM %s WHERE %s",SQL_FLD_APP_INFO, SQL_TBL_APP_INFO, w);
+	snprintf(tbl, sizeof(tbl), SQL_TBL_APP_INFO_WITH_LOCALNAME, locale);
+	free(locale);
+
+	snprintf(w, sizeof(w), sql_get_filter(prop), key);
+
+	snprintf(query, sizeof(query), "SELECT %s FROM %s WHERE %s",SQL_FLD_APP_INFO_WITH_LOCALNAME, tbl, w);
 
 	do {
 		ret = db_open(DB_OPEN_RO);
@@ -169,75 +268,208 @@ EXPORT_API ail_error_e ail_package_get_appinfo(const char *package, ail_appinfo_
 		if (ret < 0) break;
 		(*ai)->stmt = NULL;
 
+		cache_store((*ai)->values);
+
 		return AIL_ERROR_OK;
 	} while(0);
 
+	if (ret == AIL_ERROR_NO_DATA)
+		cache_store_absent(type, key);
+
 	appinfo_destroy(*ai);
 
 	return ret;
 }
 
+EXPORT_API ail_error_e ail_package_get_appinfo(const char *package, ail_appinfo_h *ai)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+
+	retv_if(!package, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+
+	recording = record_begin(&rec);
+	ret = _get_appinfo(E_AIL_PROP_PACKAGE_STR, package, ai);
+	if (recording) {
+		record_arg_str(&rec, package);
+		record_end(&rec, RECORD_PACKAGE_GET_APPINFO, ret);
+	}
+
+	return ret;
+}
+
 EXPORT_API ail_error_e ail_get_appinfo(const char *appid, ail_appinfo_h *ai)
 {
+	struct record rec;
+	bool recording;
 	ail_error_e ret;
-	char query[AIL_SQL_QUERY_MAX_LEN];
-	sqlite3_stmt *stmt = NULL;
-	char w[AIL_SQL_QUERY_MAX_LEN];
 
 	retv_if(!appid, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
 
-	*ai = appinfo_create();
-	retv_if(!*ai, AIL_ERROR_OUT_OF_MEMORY);
+	recording = record_begin(&rec);
+	ret = _get_appinfo(E_AIL_PROP_X_SLP_APPID_STR, appid, ai);
+	if (recording) {
+		record_arg_str(&rec, appid);
+		record_end(&rec, RECORD_GET_APPINFO, ret);
+	}
 
-	snprintf(w, sizeof(w), sql_get_filter(E_AIL_PROP_X_SLP_APPID_STR), appid);
+	return ret;
+}
 
-	snprintf(query, sizeof(query), "SELECT %s FROM %s WHERE %s",SQL_FLD_APP_INFO, SQL_TBL_APP_INFO, w);
 
-	do {
-		ret = db_open(DB_OPEN_RO);
-		if (ret < 0) break;
+#define EXE_PATH_CHUNK	64
 
-		ret = db_prepare(query, &stmt);
-		if (ret < 0) break;
+/* Maps each of paths[0..n) found in the exe_path index to its package */
+static ail_error_e _lookup_exe_paths(const char **paths, int n, GHashTable *packages)
+{
+	GString *q;
+	sqlite3_stmt *stmt;
+	ail_error_e ret;
+	char *value, *package;
+	int i;
 
-		ret = db_step(stmt);
-		if (ret < 0) {
-			db_finalize(stmt);
-			break;
-		}
+	q = g_string_new("SELECT value, package FROM app_token WHERE field='"SQL_FIELD_EXE_PATH"' AND value IN (");
+	retv_if(!q, AIL_ERROR_OUT_OF_MEMORY);
+	for (i = 0; i < n; i++)
+		g_string_append(q, i ? ",?" : "?");
+	g_string_append(q, ")");
 
-		(*ai)->stmt = stmt;
+	ret = db_prepare(q->str, &stmt);
+	g_string_free(q, TRUE);
+	retv_if(ret != AIL_ERROR_OK, ret);
 
-		ret = _retrieve_all_column(*ai);
-		if (ret < 0) {
-			db_finalize((*ai)->stmt);
-			break;
-		}
+	for (i = 0; i < n && ret == AIL_ERROR_OK; i++)
+		ret = db_bind_str(stmt, i + 1, paths[i]);
 
-		ret = db_finalize((*ai)->stmt);
-		if (ret < 0) break;
-		(*ai)->stmt = NULL;
+	while (ret == AIL_ERROR_OK && db_step(stmt) == AIL_ERROR_OK) {
+		db_column_str(stmt, 0, &value);
+		db_column_str(stmt, 1, &package);
+		if (value && package && !g_hash_table_lookup(packages, value))
+			g_hash_table_insert(packages, strdup(value), strdup(package));
+	}
 
-		return AIL_ERROR_OK;
-	} while(0);
+	db_finalize(stmt);
 
-	appinfo_destroy(*ai);
+	return ret;
+}
+
+static ail_error_e _get_appinfo_by_exe_paths(const char **paths, int count, ail_appinfo_h *ai)
+{
+	GHashTable *packages;
+	char **canonical;
+	const char *package;
+	ail_error_e ret = AIL_ERROR_OK;
+	int i;
+
+	retv_if(!paths, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(count <= 0, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+
+	for (i = 0; i < count; i++)
+		ai[i] = NULL;
+
+	retv_if(db_open(DB_OPEN_RO) != AIL_ERROR_OK, AIL_ERROR_DB_FAILED);
+
+	packages = g_hash_table_new_full(g_str_hash, g_str_equal, free, free);
+	retv_if(!packages, AIL_ERROR_OUT_OF_MEMORY);
+
+	canonical = calloc(count, sizeof(char *));
+	if (!canonical) {
+		g_hash_table_destroy(packages);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (i = 0; i < count && ret == AIL_ERROR_OK; i += EXE_PATH_CHUNK)
+		ret = _lookup_exe_paths(paths + i, MIN(EXE_PATH_CHUNK, count - i), packages);
+
+	/* Paths given through a symlink the index does not know */
+	for (i = 0; i < count && ret == AIL_ERROR_OK; i++) {
+		if (!paths[i] || g_hash_table_lookup(packages, paths[i]))
+			continue;
+		canonical[i] = realpath(paths[i], NULL);
+		if (canonical[i] && !g_hash_table_lookup(packages, canonical[i]))
+			ret = _lookup_exe_paths((const char **)&canonical[i], 1, packages);
+	}
+
+	for (i = 0; i < count && ret == AIL_ERROR_OK; i++) {
+		if (!paths[i])
+			continue;
+		package = g_hash_table_lookup(packages, paths[i]);
+		if (!package && canonical[i])
+			package = g_hash_table_lookup(packages, canonical[i]);
+		if (!package)
+			continue;
+
+		ret = ail_package_get_appinfo(package, &ai[i]);
+		if (ret == AIL_ERROR_NO_DATA) {
+			ai[i] = NULL;
+			ret = AIL_ERROR_OK;
+		}
+	}
+
+	if (ret != AIL_ERROR_OK) {
+		for (i = 0; i < count; i++) {
+			if (ai[i]) {
+				ail_destroy_appinfo(ai[i]);
+				ai[i] = NULL;
+			}
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		free(canonical[i]);
+	free(canonical);
+	g_hash_table_destroy(packages);
 
 	return ret;
 }
 
+EXPORT_API ail_error_e ail_get_appinfo_by_exe_paths(const char **paths, int count, ail_appinfo_h *ai)
+{
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
+	int i;
 
-EXPORT_API ail_error_e ail_appinfo_get_bool(const ail_appinfo_h ai, const char *property, bool *value)
+	recording = record_begin(&rec);
+	ret = _get_appinfo_by_exe_paths(paths, count, ai);
+	if (recording) {
+		for (i = 0; paths && i < count; i++)
+			record_arg_str(&rec, paths[i]);
+		record_end(&rec, RECORD_GET_APPINFO_BY_EXE_PATHS, ret);
+	}
+
+	return ret;
+}
+
+EXPORT_API ail_error_e ail_get_appinfo_by_exe_path(const char *path, ail_appinfo_h *ai)
 {
-	ail_prop_bool_e prop;
-	int val;
+	struct record rec;
+	bool recording;
+	ail_error_e ret;
 
+	retv_if(!path, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
 
-	prop = _ail_convert_to_prop_bool(property);
+	recording = record_begin(&rec);
+	ret = _get_appinfo_by_exe_paths(&path, 1, ai);
+	if (ret == AIL_ERROR_OK && !*ai)
+		ret = AIL_ERROR_NO_DATA;
+	if (recording) {
+		record_arg_str(&rec, path);
+		record_end(&rec, RECORD_GET_APPINFO_BY_EXE_PATH, ret);
+	}
+
+	return ret;
+}
+
+
+static ail_error_e _appinfo_get_bool(const ail_appinfo_h ai, ail_prop_bool_e prop, bool *value)
+{
+	int val;
 
 	if (prop < E_AIL_PROP_BOOL_MIN || prop > E_AIL_PROP_BOOL_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
@@ -256,16 +488,29 @@ EXPORT_API ail_error_e ail_appinfo_get_bool(const ail_appinfo_h ai, const char *
 
 
 
-EXPORT_API ail_error_e ail_appinfo_get_int(const ail_appinfo_h ai, const char *property, int *value)
+EXPORT_API ail_error_e ail_appinfo_get_bool(const ail_appinfo_h ai, const char *property, bool *value)
 {
-	ail_prop_int_e prop;
-
 	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
 	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
 
-	prop = _ail_convert_to_prop_int(property);
+	return _appinfo_get_bool(ai, _ail_convert_to_prop_bool(property), value);
+}
+
+
+
+EXPORT_API ail_error_e ail_appinfo_get_bool_by_id(const ail_appinfo_h ai, ail_prop_id_e id, bool *value)
+{
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
+
+	return _appinfo_get_bool(ai, (ail_prop_bool_e)id, value);
+}
+
+
 
+static ail_error_e _appinfo_get_int(const ail_appinfo_h ai, ail_prop_int_e prop, int *value)
+{
 	if (prop < E_AIL_PROP_INT_MIN || prop > E_AIL_PROP_INT_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
 
@@ -280,98 +525,137 @@ EXPORT_API ail_error_e ail_appinfo_get_int(const ail_appinfo_h ai, const char *p
 	return AIL_ERROR_OK;
 }
 
-#define QUERY_GET_LOCALNAME "select name from localname where package='%s' and locale='%s'"
 
-char *appinfo_get_localname(const char *package, char *locale)
+
+EXPORT_API ail_error_e ail_appinfo_get_int(const ail_appinfo_h ai, const char *property, int *value)
 {
-	db_open(DB_OPEN_RO);
-	sqlite3_stmt *stmt;
-	char *str = NULL;
-	char *localname;
-	char query[512];
-	
-	snprintf(query, sizeof(query), QUERY_GET_LOCALNAME, package, locale);
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
 
-	_D("Query = %s",query);
-	retv_if (db_prepare(query, &stmt) < 0, NULL);
+	return _appinfo_get_int(ai, _ail_convert_to_prop_int(property), value);
+}
 
-	do {
-		if (db_step(stmt) < 0)
-			break;
-		if (db_column_str(stmt, 0, &str) < 0)
-			break;
-		if (str)
-			localname = strdup(str);
-		else
-			localname = NULL;
 
-		db_finalize(stmt);
 
-		return localname;
-	} while(0);
+EXPORT_API ail_error_e ail_appinfo_get_int_by_id(const ail_appinfo_h ai, ail_prop_id_e id, int *value)
+{
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!value, AIL_ERROR_INVALID_PARAMETER);
 
-	db_finalize(stmt);
-	return NULL;
+	return _appinfo_get_int(ai, (ail_prop_int_e)id, value);
 }
 
-
-EXPORT_API ail_error_e ail_appinfo_get_str(const ail_appinfo_h ai, const char *property, char **str)
+static ail_error_e _appinfo_get_value_str(const ail_appinfo_h ai, ail_prop_str_e prop, char **str)
 {
 	int index;
 	char *value;
-	char *pkg;
-	char *locale, *localname;
-	ail_prop_str_e prop;
-
-	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
-	retv_if(!str, AIL_ERROR_INVALID_PARAMETER);
-
-	prop = _ail_convert_to_prop_str(property);
+	char *localname;
 
 	if (prop < E_AIL_PROP_STR_MIN || prop > E_AIL_PROP_STR_MAX)
 		return AIL_ERROR_INVALID_PARAMETER;
 
-	localname = NULL;
+	/* Detached handles got the localized name with the lookup query */
+	if (!ai->stmt) {
+		*str = ai->values[prop];
+		return AIL_ERROR_OK;
+	}
 
 	if (E_AIL_PROP_NAME_STR == prop) {
-		if (ai->stmt) {
-			if (db_column_str(ai->stmt, SQL_LOCALNAME_IDX, &localname) < 0)
-				return AIL_ERROR_DB_FAILED;
-		} else {
-			pkg = ai->values[E_AIL_PROP_PACKAGE_STR];
-
-			retv_if (NULL == pkg, AIL_ERROR_FAIL);
-			locale = sql_get_locale();
-			retv_if (NULL == locale, AIL_ERROR_FAIL);
-			localname = (char *)appinfo_get_localname(pkg,locale);
-			free(locale);
-		}
-
+		if (db_column_str(ai->stmt, SQL_LOCALNAME_IDX, &localname) < 0)
+			return AIL_ERROR_DB_FAILED;
 		if (localname) {
-			if (!ai->stmt) {
-				if (ai->values) {
-					if (ai->values[prop])
-						free(ai->values[prop]);
-					ai->values[prop] = localname;
-				}
-			}
 			*str = localname;
 			return AIL_ERROR_OK;
 		}
 	}
 
-	if (ai->stmt) {
-		index = sql_get_app_info_idx(prop);
-		if (db_column_str(ai->stmt, index, &value) < 0){
-			return AIL_ERROR_DB_FAILED;
+	index = sql_get_app_info_idx(prop);
+	if (db_column_str(ai->stmt, index, &value) < 0){
+		return AIL_ERROR_DB_FAILED;
+	}
+	*str = value;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+/* The DB keeps the icon name, its path depends on the theme */
+static ail_error_e _appinfo_get_icon(const ail_appinfo_h ai, const char *theme, const char *size, char **path)
+{
+	char *name;
+	char *icon;
+	GSList *l;
+	ail_error_e ret;
+
+	ret = _appinfo_get_value_str(ai, E_AIL_PROP_ICON_STR, &name);
+	retv_if(ret != AIL_ERROR_OK, ret);
+
+	/* Unset fields were written with printf as "(null)" */
+	if (!name || !strcmp(name, "(null)")) {
+		*path = name;
+		return AIL_ERROR_OK;
+	}
+
+	icon = icon_resolve(name, theme, size);
+	retv_if(!icon, AIL_ERROR_OUT_OF_MEMORY);
+
+	/* Paths given before stay valid, asking again hands out the same one */
+	for (l = ai->icons; l; l = g_slist_next(l)) {
+		if (!strcmp(l->data, icon)) {
+			free(icon);
+			*path = l->data;
+			return AIL_ERROR_OK;
 		}
-		*str = value;
-	} else
-		*str = ai->values[prop];
+	}
+
+	ai->icons = g_slist_prepend(ai->icons, icon);
+	*path = icon;
 
 	return AIL_ERROR_OK;
 }
 
+static ail_error_e _appinfo_get_str(const ail_appinfo_h ai, ail_prop_str_e prop, char **str)
+{
+	if (E_AIL_PROP_ICON_STR == prop)
+		return _appinfo_get_icon(ai, NULL, NULL, str);
+
+	return _appinfo_get_value_str(ai, prop, str);
+}
+
+EXPORT_API ail_error_e ail_appinfo_get_str(const ail_appinfo_h ai, const char *property, char **str)
+{
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!property, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!str, AIL_ERROR_INVALID_PARAMETER);
+
+	return _appinfo_get_str(ai, _ail_convert_to_prop_str(property), str);
+}
+
+
+
+EXPORT_API ail_error_e ail_appinfo_get_str_by_id(const ail_appinfo_h ai, ail_prop_id_e id, char **str)
+{
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!str, AIL_ERROR_INVALID_PARAMETER);
+
+	return _appinfo_get_str(ai, (ail_prop_str_e)id, str);
+}
+
+EXPORT_API ail_error_e ail_appinfo_get_icon_path(const ail_appinfo_h ai, const char *theme, const char *size, char **path)
+{
+	ail_error_e ret;
+
+	retv_if(!ai, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!path, AIL_ERROR_INVALID_PARAMETER);
+
+	ret = _appinfo_get_icon(ai, theme, size, path);
+	if (ret == AIL_ERROR_OK && *path && !strcmp(*path, "(null)"))
+		*path = NULL;
+
+	return ret;
+}
+
 
 // End of file
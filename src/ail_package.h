@@ -31,5 +31,8 @@
 ail_appinfo_h appinfo_create(void);
 void appinfo_destroy(ail_appinfo_h ai);
 void appinfo_set_stmt(ail_appinfo_h ai, sqlite3_stmt *stmt);
+void appinfo_set_values(ail_appinfo_h ai, char **values);
+void appinfo_next_row(ail_appinfo_h ai);
+ail_appinfo_h appinfo_detach(const ail_appinfo_h ai);
 
 #endif  /* __AIL_PACKAGE_H__ */
@@ -91,7 +91,17 @@ enum {
 #define ELEMENT_BOOL(e) ((struct element_bool *)(e))
 
 #define AIL_SQL_QUERY_MAX_LEN	2048
-#define APP_INFO_DB "/opt/dbspace/.app_info.db"
+
+/* Prepended to the platform paths, to run off-device */
+#ifndef AIL_ROOT
+#define AIL_ROOT ""
+#endif
+
+#define APP_INFO_DB AIL_ROOT"/opt/dbspace/.app_info.db"
+#define APP_INFO_SNAPSHOT AIL_ROOT"/opt/dbspace/.app_info.snapshot"
+#define APP_INFO_GENERATION AIL_ROOT"/opt/dbspace/.app_info.generation"
+#define AIL_DB_CONF AIL_ROOT"/opt/dbspace/.app_info.conf"
+#define AIL_NOTI_KEY "memory/menuscreen/desktop"
 
 #define ELEMENT_TYPE(e, t) do { \
 	if(e->prop >= E_AIL_PROP_STR_MIN && e->prop <= E_AIL_PROP_STR_MAX) t= (int)VAL_TYPE_STR; \
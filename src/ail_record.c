@@ -0,0 +1,306 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_record.h"
+
+#define RECORD_BUF_SIZE (64 * 1024)
+/* At most this much of the trace is lost when a process dies without exit() */
+#define RECORD_FLUSH_US 1000000
+
+int record_enabled = -1;	/* -1 until AIL_RECORD was looked at */
+
+static struct {
+	pthread_mutex_t lock;
+	char *path;
+	int fd;
+	int len;
+	uint64_t flushed_us;
+	unsigned char buf[RECORD_BUF_SIZE];
+} out = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.fd = -1,
+};
+
+static pthread_once_t record_once = PTHREAD_ONCE_INIT;
+static unsigned int threads;
+static __thread unsigned int thread_id;
+static __thread bool in_call;
+
+
+
+static uint64_t _now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+
+
+/* Called with out.lock held */
+static int _open(void)
+{
+	struct record_header h = { .version = RECORD_VERSION, };
+	char name[PATH_MAX];
+
+	snprintf(name, sizeof(name), "%s.%d", out.path, getpid());
+	out.fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (out.fd < 0) {
+		_E("Cannot open the call trace %s", name);
+		return -1;
+	}
+
+	memcpy(h.magic, RECORD_MAGIC, sizeof(h.magic));
+	h.pid = getpid();
+	memcpy(out.buf, &h, sizeof(h));
+	out.len = sizeof(h);
+	out.flushed_us = _now_us();
+
+	return 0;
+}
+
+
+
+/* Called with out.lock held */
+static void _flush(void)
+{
+	const unsigned char *p = out.buf;
+	int left = out.len;
+	ssize_t n;
+
+	while (left > 0 && out.fd >= 0) {
+		n = write(out.fd, p, left);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			_E("Cannot write the call trace, recording stops");
+			close(out.fd);
+			out.fd = -1;
+			__atomic_store_n(&record_enabled, 0, __ATOMIC_RELAXED);
+			break;
+		}
+		p += n;
+		left -= n;
+	}
+
+	out.len = 0;
+	out.flushed_us = _now_us();
+}
+
+
+
+static void _flush_at_exit(void)
+{
+	pthread_mutex_lock(&out.lock);
+	_flush();
+	pthread_mutex_unlock(&out.lock);
+}
+
+
+
+static void _fork_prepare(void)
+{
+	pthread_mutex_lock(&out.lock);
+}
+
+
+
+static void _fork_parent(void)
+{
+	pthread_mutex_unlock(&out.lock);
+}
+
+
+
+/* The parent writes what it buffered, the child gets a file of its own */
+static void _fork_child(void)
+{
+	if (out.fd >= 0)
+		close(out.fd);
+	out.fd = -1;
+	out.len = 0;
+
+	if (_open() < 0)
+		__atomic_store_n(&record_enabled, 0, __ATOMIC_RELAXED);
+
+	pthread_mutex_unlock(&out.lock);
+}
+
+
+
+static void _init(void)
+{
+	const char *path;
+	int r;
+
+	path = getenv("AIL_RECORD");
+	if (!path || !*path || !(out.path = strdup(path))) {
+		__atomic_store_n(&record_enabled, 0, __ATOMIC_RELEASE);
+		return;
+	}
+
+	pthread_mutex_lock(&out.lock);
+	r = _open();
+	pthread_mutex_unlock(&out.lock);
+	if (r < 0) {
+		__atomic_store_n(&record_enabled, 0, __ATOMIC_RELEASE);
+		return;
+	}
+
+	atexit(_flush_at_exit);
+	pthread_atfork(_fork_prepare, _fork_parent, _fork_child);
+
+	__atomic_store_n(&record_enabled, 1, __ATOMIC_RELEASE);
+}
+
+
+
+bool record_enter(struct record *rec)
+{
+	pthread_once(&record_once, _init);
+	if (!__atomic_load_n(&record_enabled, __ATOMIC_ACQUIRE))
+		return false;
+
+	/* What a recorded call calls is part of its time */
+	if (in_call)
+		return false;
+	in_call = true;
+
+	rec->len = 0;
+	rec->full = false;
+	rec->start_us = _now_us();
+
+	return true;
+}
+
+
+
+void record_end(struct record *rec, enum record_api api, ail_error_e ret)
+{
+	struct record_entry e;
+	uint64_t duration = _now_us() - rec->start_us;
+
+	in_call = false;
+
+	if (!thread_id)
+		thread_id = __atomic_add_fetch(&threads, 1, __ATOMIC_RELAXED);
+
+	e.start_us = rec->start_us;
+	e.duration_us = duration > UINT32_MAX ? UINT32_MAX : duration;
+	e.thread = thread_id;
+	e.ret = ret;
+	e.api = api;
+	e.len = rec->len;
+
+	pthread_mutex_lock(&out.lock);
+	if (out.fd >= 0) {
+		if (out.len + sizeof(e) + rec->len > sizeof(out.buf))
+			_flush();
+		memcpy(out.buf + out.len, &e, sizeof(e));
+		memcpy(out.buf + out.len + sizeof(e), rec->args, rec->len);
+		out.len += sizeof(e) + rec->len;
+		if (e.start_us + e.duration_us - out.flushed_us > RECORD_FLUSH_US)
+			_flush();
+	}
+	pthread_mutex_unlock(&out.lock);
+}
+
+
+
+static void _arg(struct record *rec, const void *value, int size)
+{
+	if (rec->full || rec->len + size > RECORD_ARGS_MAX) {
+		rec->full = true;
+		return;
+	}
+
+	memcpy(rec->args + rec->len, value, size);
+	rec->len += size;
+}
+
+
+
+void record_arg_byte(struct record *rec, int value)
+{
+	unsigned char v = value;
+
+	_arg(rec, &v, sizeof(v));
+}
+
+
+
+void record_arg_int(struct record *rec, int value)
+{
+	int32_t v = value;
+
+	_arg(rec, &v, sizeof(v));
+}
+
+
+
+void record_arg_int64(struct record *rec, long long value)
+{
+	int64_t v = value;
+
+	_arg(rec, &v, sizeof(v));
+}
+
+
+
+void record_arg_str(struct record *rec, const char *value)
+{
+	if (!value)
+		value = "";
+
+	_arg(rec, value, strlen(value) + 1);
+}
+
+
+
+ail_cb_ret_e record_rows_cb(const ail_appinfo_h ai, void *user_data)
+{
+	struct record_rows *r = user_data;
+
+	r->rows++;
+
+	return r->cb(ai, r->user_data);
+}
+
+
+// End of file.
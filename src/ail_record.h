@@ -0,0 +1,116 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#ifndef __AIL_RECORD_H__
+#define __AIL_RECORD_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ail.h"
+
+/*
+ * Call trace written while AIL_RECORD names a file, one file per process: <AIL_RECORD>.<pid>.
+ * A struct record_header, then for each call a struct record_entry followed by its arguments.
+ * Integers are in host order; strings end with their NUL.
+ */
+#define RECORD_MAGIC "AILTRACE"
+#define RECORD_VERSION 1
+#define RECORD_ARGS_MAX 2048
+
+enum record_api {
+	RECORD_GET_APPINFO = 1,			/* appid */
+	RECORD_PACKAGE_GET_APPINFO,		/* package */
+	RECORD_GET_APPINFO_BY_EXE_PATH,		/* path */
+	RECORD_GET_APPINFO_BY_EXE_PATHS,	/* path... ("" for NULL) */
+	RECORD_FILTER_COUNT,			/* filter */
+	RECORD_FILTER_FOREACH,			/* int32 rows, filter */
+	RECORD_MIME_GET_HANDLERS,		/* int32 rows, mime */
+	RECORD_CHANGES_SINCE,			/* int64 seq */
+	RECORD_DESKTOP_ADD,			/* package */
+	RECORD_DESKTOP_UPDATE,			/* package */
+	RECORD_DESKTOP_REMOVE,			/* package */
+	RECORD_DESKTOP_MODIFY_BOOL,		/* package, property, byte value */
+	RECORD_DESKTOP_BATCH_BEGIN,
+	RECORD_DESKTOP_BATCH_END,
+	RECORD_API_MAX,
+};
+
+/* A filter is a list of conditions, a tag byte then prop byte and value */
+#define RECORD_FILTER_BOOL 'b'	/* byte value */
+#define RECORD_FILTER_INT 'i'	/* int32 value */
+#define RECORD_FILTER_STR 's'	/* string value */
+#define RECORD_FILTER_SEARCH 'q'	/* string terms, no prop byte */
+
+struct record_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t pid;
+};
+
+struct record_entry {
+	uint64_t start_us;	/* CLOCK_MONOTONIC, comparable across processes */
+	uint32_t duration_us;
+	uint32_t thread;	/* numbered from 1 in order of the first recorded call */
+	int32_t ret;
+	uint16_t api;
+	uint16_t len;		/* of the arguments that follow */
+};
+
+/* One call being recorded */
+struct record {
+	uint64_t start_us;
+	int len;
+	bool full;		/* an argument did not fit, the following ones are dropped */
+	unsigned char args[RECORD_ARGS_MAX];
+};
+
+/* Counts the rows a caller's callback saw, for replaying early cancels */
+struct record_rows {
+	ail_list_appinfo_cb cb;
+	void *user_data;
+	int rows;
+};
+
+extern int record_enabled;
+
+bool record_enter(struct record *rec);
+void record_end(struct record *rec, enum record_api api, ail_error_e ret);
+void record_arg_byte(struct record *rec, int value);
+void record_arg_int(struct record *rec, int value);
+void record_arg_int64(struct record *rec, long long value);
+void record_arg_str(struct record *rec, const char *value);
+ail_cb_ret_e record_rows_cb(const ail_appinfo_h ai, void *user_data);
+
+/* False when not recording, or when called from inside a recorded call */
+static inline bool record_begin(struct record *rec)
+{
+	if (__builtin_expect(!__atomic_load_n(&record_enabled, __ATOMIC_RELAXED), 1))
+		return false;
+
+	return record_enter(rec);
+}
+
+#endif  /* __AIL_RECORD_H__ */
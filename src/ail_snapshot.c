@@ -0,0 +1,894 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <glib.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_db.h"
+#include "ail_sql.h"
+#include "ail_package.h"
+#include "ail_snapshot.h"
+
+#define SNAPSHOT_MAGIC		"AILSNAP"
+#define SNAPSHOT_VERSION	2
+#define SNAPSHOT_NULL		UINT32_MAX
+
+/*
+ * Layout of the snapshot file. All offsets are relative to the start of
+ * the file, string references are offsets into the string table.
+ *
+ * header | rows[n_rows] | appids[n_appids] | localnames[n_localnames] | strings
+ *
+ * Rows are sorted by package, appids holds row indices sorted by appid.
+ */
+struct snapshot_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t serial;
+	uint32_t size;
+	uint32_t n_props;
+	uint32_t n_rows;
+	uint32_t n_appids;
+	uint32_t n_localnames;
+	uint32_t rows;
+	uint32_t appids;
+	uint32_t localnames;
+	uint32_t strings;
+	uint64_t generation;	/* of the DB the rows were read from */
+};
+
+struct snapshot_row {
+	uint32_t values[NUM_OF_PROP];
+	uint32_t localname;
+	uint32_t n_localname;
+};
+
+struct snapshot_localname {
+	uint32_t locale;
+	uint32_t name;
+};
+
+struct snapshot {
+	int ref;
+	void *addr;
+	size_t len;
+	dev_t dev;
+	ino_t ino;
+	const struct snapshot_header *hdr;
+	const struct snapshot_row *rows;
+	const uint32_t *appids;
+	const struct snapshot_localname *localnames;
+	const char *strings;
+	uint32_t strings_len;
+};
+
+static struct {
+	pthread_mutex_t lock;
+	bool enabled;
+	struct snapshot *current;
+} reader = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.enabled = false,
+	.current = NULL,
+};
+
+
+
+/* Writer */
+struct builder {
+	GHashTable *offsets;
+	GString *strings;
+	GArray *rows;
+	GArray *localnames;
+	GArray *appids;
+	unsigned long long generation;
+};
+
+static uint32_t _intern(struct builder *b, const char *str)
+{
+	gpointer off;
+	uint32_t o;
+
+	if (!str)
+		return SNAPSHOT_NULL;
+
+	/* offsets are stored +1 so that a missing key can be told from offset 0 */
+	off = g_hash_table_lookup(b->offsets, str);
+	if (off)
+		return GPOINTER_TO_UINT(off) - 1;
+
+	o = b->strings->len;
+	g_string_append_len(b->strings, str, strlen(str) + 1);
+	g_hash_table_insert(b->offsets, strdup(str), GUINT_TO_POINTER(o + 1));
+
+	return o;
+}
+
+
+
+static int _cmp_appid(const void *a, const void *b, void *data)
+{
+	const struct builder *bd = data;
+	const struct snapshot_row *ra = &g_array_index(bd->rows, struct snapshot_row, *(const uint32_t *)a);
+	const struct snapshot_row *rb = &g_array_index(bd->rows, struct snapshot_row, *(const uint32_t *)b);
+
+	return strcmp(bd->strings->str + ra->values[E_AIL_PROP_X_SLP_APPID_STR],
+			bd->strings->str + rb->values[E_AIL_PROP_X_SLP_APPID_STR]);
+}
+
+
+
+static ail_error_e _build(struct builder *b)
+{
+	char query[AIL_SQL_QUERY_MAX_LEN];
+	sqlite3_stmt *stmt, *lstmt;
+	ail_error_e ret, lret;
+	char *col, *lpkg;
+	int i, cmp;
+
+	retv_if(db_open(DB_OPEN_RO) < 0, AIL_ERROR_DB_FAILED);
+
+	snprintf(query, sizeof(query), "SELECT %s FROM %s ORDER BY app_info.package",
+			SQL_FLD_APP_INFO, SQL_TBL_APP_INFO);
+	retv_if(db_prepare(query, &stmt) < 0, AIL_ERROR_DB_FAILED);
+
+	if (db_prepare("SELECT package, locale, name FROM localname ORDER BY package, locale", &lstmt) < 0) {
+		db_finalize(stmt);
+		return AIL_ERROR_DB_FAILED;
+	}
+
+	lret = db_step(lstmt);
+	while ((ret = db_step(stmt)) == AIL_ERROR_OK) {
+		struct snapshot_row row;
+		char *package;
+
+		db_column_str(stmt, E_AIL_PROP_PACKAGE_STR, &package);
+		if (!package)
+			continue;
+
+		for (i = 0; i < NUM_OF_PROP; i++) {
+			db_column_str(stmt, sql_get_app_info_idx(i), &col);
+			row.values[i] = _intern(b, col);
+		}
+
+		/* Both statements are ordered by package, so merge the localnames in */
+		row.localname = b->localnames->len;
+		row.n_localname = 0;
+		while (lret == AIL_ERROR_OK) {
+			struct snapshot_localname ln;
+
+			db_column_str(lstmt, 0, &lpkg);
+			cmp = strcmp(lpkg, package);
+			if (cmp > 0)
+				break;
+
+			if (cmp == 0) {
+				db_column_str(lstmt, 1, &col);
+				ln.locale = _intern(b, col);
+				db_column_str(lstmt, 2, &col);
+				ln.name = _intern(b, col);
+				g_array_append_val(b->localnames, ln);
+				row.n_localname++;
+			}
+
+			lret = db_step(lstmt);
+		}
+
+		if (row.values[E_AIL_PROP_X_SLP_APPID_STR] != SNAPSHOT_NULL) {
+			uint32_t idx = b->rows->len;
+			g_array_append_val(b->appids, idx);
+		}
+		g_array_append_val(b->rows, row);
+	}
+
+	db_finalize(lstmt);
+	db_finalize(stmt);
+
+	retv_if(ret != AIL_ERROR_NO_DATA, AIL_ERROR_DB_FAILED);
+	retv_if(lret != AIL_ERROR_OK && lret != AIL_ERROR_NO_DATA, AIL_ERROR_DB_FAILED);
+
+	qsort_r(b->appids->data, b->appids->len, sizeof(uint32_t), _cmp_appid, b);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static uint32_t _read_serial(void)
+{
+	struct snapshot_header hdr;
+	FILE *fp;
+	uint32_t serial = 0;
+
+	fp = fopen(APP_INFO_SNAPSHOT, "r");
+	if (!fp)
+		return 0;
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) == 1
+			&& !memcmp(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic)))
+		serial = hdr.serial;
+
+	fclose(fp);
+
+	return serial;
+}
+
+
+
+static ail_error_e _write(struct builder *b)
+{
+	struct snapshot_header hdr = {SNAPSHOT_MAGIC, };
+	char tmp[FILENAME_MAX];
+	FILE *fp;
+	int failed;
+
+	hdr.version = SNAPSHOT_VERSION;
+	hdr.generation = b->generation;
+	hdr.serial = _read_serial() + 1;
+	hdr.n_props = NUM_OF_PROP;
+	hdr.n_rows = b->rows->len;
+	hdr.n_appids = b->appids->len;
+	hdr.n_localnames = b->localnames->len;
+	hdr.rows = sizeof(hdr);
+	hdr.appids = hdr.rows + hdr.n_rows * sizeof(struct snapshot_row);
+	hdr.localnames = hdr.appids + hdr.n_appids * sizeof(uint32_t);
+	hdr.strings = hdr.localnames + hdr.n_localnames * sizeof(struct snapshot_localname);
+	hdr.size = hdr.strings + b->strings->len;
+
+	/* Readers may still map the old file, so never write it in place */
+	snprintf(tmp, sizeof(tmp), "%s.%d", APP_INFO_SNAPSHOT, getpid());
+	fp = fopen(tmp, "w");
+	retv_if(!fp, AIL_ERROR_FAIL);
+
+	failed = fwrite(&hdr, sizeof(hdr), 1, fp) != 1;
+	if (hdr.n_rows)
+		failed |= fwrite(b->rows->data, sizeof(struct snapshot_row), hdr.n_rows, fp) != hdr.n_rows;
+	if (hdr.n_appids)
+		failed |= fwrite(b->appids->data, sizeof(uint32_t), hdr.n_appids, fp) != hdr.n_appids;
+	if (hdr.n_localnames)
+		failed |= fwrite(b->localnames->data, sizeof(struct snapshot_localname),
+				hdr.n_localnames, fp) != hdr.n_localnames;
+	if (b->strings->len)
+		failed |= fwrite(b->strings->str, b->strings->len, 1, fp) != 1;
+	failed |= fflush(fp) != 0;
+	failed |= fsync(fileno(fp)) != 0;
+	failed |= fclose(fp) != 0;
+
+	if (failed || chmod(tmp, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) < 0
+			|| rename(tmp, APP_INFO_SNAPSHOT) < 0) {
+		_E("Cannot publish %s", APP_INFO_SNAPSHOT);
+		unlink(tmp);
+		return AIL_ERROR_FAIL;
+	}
+
+	_D("Snapshot %u : %u rows, %u bytes", hdr.serial, hdr.n_rows, hdr.size);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+ail_error_e snapshot_publish(void)
+{
+	struct builder b;
+	ail_error_e ret;
+
+	b.offsets = g_hash_table_new_full(g_str_hash, g_str_equal, free, NULL);
+	b.strings = g_string_new(NULL);
+	b.rows = g_array_new(FALSE, FALSE, sizeof(struct snapshot_row));
+	b.localnames = g_array_new(FALSE, FALSE, sizeof(struct snapshot_localname));
+	b.appids = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+
+	/* Read before the rows, a snapshot is never stamped newer than its data */
+	b.generation = 0;
+	db_read_generation(&b.generation);
+
+	ret = _build(&b);
+	if (ret == AIL_ERROR_OK)
+		ret = _write(&b);
+
+	g_array_free(b.appids, TRUE);
+	g_array_free(b.localnames, TRUE);
+	g_array_free(b.rows, TRUE);
+	g_string_free(b.strings, TRUE);
+	g_hash_table_destroy(b.offsets);
+
+	return ret;
+}
+
+
+
+void snapshot_republish(void)
+{
+	/* Only devices that published a snapshot once keep it up to date */
+	if (access(APP_INFO_SNAPSHOT, F_OK) < 0)
+		return;
+
+	if (snapshot_publish() != AIL_ERROR_OK) {
+		_E("Remove the stale snapshot");
+		unlink(APP_INFO_SNAPSHOT);
+	}
+}
+
+
+
+/* Readers go to the DB until the next snapshot_publish(), true if there was a snapshot */
+bool snapshot_withdraw(void)
+{
+	return unlink(APP_INFO_SNAPSHOT) == 0;
+}
+
+
+
+/* Reader */
+static int _validate(const struct snapshot_header *hdr, size_t len)
+{
+	retv_if(memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic)), -1);
+	retv_if(hdr->version != SNAPSHOT_VERSION, -1);
+	retv_if(hdr->n_props != NUM_OF_PROP, -1);
+	retv_if(hdr->size != len, -1);
+	retv_if(hdr->rows < sizeof(struct snapshot_header), -1);
+	retv_if(hdr->rows + (uint64_t)hdr->n_rows * sizeof(struct snapshot_row) > hdr->appids, -1);
+	retv_if(hdr->appids + (uint64_t)hdr->n_appids * sizeof(uint32_t) > hdr->localnames, -1);
+	retv_if(hdr->localnames + (uint64_t)hdr->n_localnames * sizeof(struct snapshot_localname) > hdr->strings, -1);
+	retv_if(hdr->strings > len, -1);
+	retv_if(hdr->strings < len && ((const char *)hdr)[len - 1] != '\0', -1);
+
+	return 0;
+}
+
+
+
+static struct snapshot *_map(void)
+{
+	struct snapshot *s;
+	struct stat st;
+	void *addr;
+	int fd;
+
+	fd = open(APP_INFO_SNAPSHOT, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size < sizeof(struct snapshot_header)) {
+		close(fd);
+		return NULL;
+	}
+
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	retv_if(addr == MAP_FAILED, NULL);
+
+	if (_validate(addr, st.st_size) < 0) {
+		_E("Ignore the invalid snapshot %s", APP_INFO_SNAPSHOT);
+		munmap(addr, st.st_size);
+		return NULL;
+	}
+
+	s = calloc(1, sizeof(struct snapshot));
+	if (!s) {
+		munmap(addr, st.st_size);
+		return NULL;
+	}
+
+	s->ref = 1;
+	s->addr = addr;
+	s->len = st.st_size;
+	s->dev = st.st_dev;
+	s->ino = st.st_ino;
+	s->hdr = addr;
+	s->rows = (const void *)((const char *)addr + s->hdr->rows);
+	s->appids = (const void *)((const char *)addr + s->hdr->appids);
+	s->localnames = (const void *)((const char *)addr + s->hdr->localnames);
+	s->strings = (const char *)addr + s->hdr->strings;
+	s->strings_len = s->len - s->hdr->strings;
+
+	_D("Mapped snapshot %u", s->hdr->serial);
+
+	return s;
+}
+
+
+
+/* Must be called with reader.lock held */
+static void _unref(struct snapshot *s)
+{
+	if (--s->ref > 0)
+		return;
+
+	munmap(s->addr, s->len);
+	free(s);
+}
+
+
+
+/* Must be called with reader.lock held */
+static void _drop_current(void)
+{
+	if (!reader.current)
+		return;
+
+	_unref(reader.current);
+	reader.current = NULL;
+}
+
+
+
+static struct snapshot *_get(void)
+{
+	struct snapshot *s = NULL;
+	unsigned long long generation;
+	struct stat st;
+
+	pthread_mutex_lock(&reader.lock);
+
+	do {
+		if (!reader.enabled)
+			break;
+
+		if (!db_read_generation(&generation)) {
+			_drop_current();
+			break;
+		}
+
+		/* Writers publish the generation before the snapshot, look for a new file only until it shows up */
+		if (!reader.current || reader.current->hdr->generation != generation) {
+			if (stat(APP_INFO_SNAPSHOT, &st) < 0) {
+				_drop_current();
+				break;
+			}
+
+			/* Each publish renames a new file into place */
+			if (!reader.current || reader.current->ino != st.st_ino
+					|| reader.current->dev != st.st_dev) {
+				_drop_current();
+				reader.current = _map();
+			}
+
+			/* Older than the DB, kept mapped only to tell when it is replaced */
+			if (!reader.current || reader.current->hdr->generation != generation)
+				break;
+		}
+
+		s = reader.current;
+		if (s)
+			s->ref++;
+	} while (0);
+
+	pthread_mutex_unlock(&reader.lock);
+
+	return s;
+}
+
+
+
+static void _put(struct snapshot *s)
+{
+	pthread_mutex_lock(&reader.lock);
+	_unref(s);
+	pthread_mutex_unlock(&reader.lock);
+}
+
+
+
+static inline const char *_str(const struct snapshot *s, uint32_t off)
+{
+	if (off >= s->strings_len)
+		return NULL;
+
+	return s->strings + off;
+}
+
+
+
+static const char *_localname(const struct snapshot *s, const struct snapshot_row *row, const char *locale)
+{
+	const struct snapshot_localname *ln;
+	const char *l;
+	uint32_t i;
+
+	if (!locale)
+		return NULL;
+
+	if (row->localname > s->hdr->n_localnames
+			|| row->n_localname > s->hdr->n_localnames - row->localname)
+		return NULL;
+
+	for (i = 0; i < row->n_localname; i++) {
+		ln = &s->localnames[row->localname + i];
+		l = _str(s, ln->locale);
+		if (l && !strcmp(l, locale))
+			return _str(s, ln->name);
+	}
+
+	return NULL;
+}
+
+
+
+/* Fill values with pointers into the mapping, NAME already localized */
+static void _row_values(const struct snapshot *s, const struct snapshot_row *row,
+			const char *locale, char **values)
+{
+	const char *localname;
+	int i;
+
+	for (i = 0; i < NUM_OF_PROP; i++)
+		values[i] = (char *)_str(s, row->values[i]);
+
+	localname = _localname(s, row, locale);
+	if (localname)
+		values[E_AIL_PROP_NAME_STR] = (char *)localname;
+}
+
+
+
+static bool _match_token(const char *column, const char *value)
+{
+	const char *p, *end;
+	size_t len = strlen(value);
+
+	if (!len)
+		return false;
+
+	for (p = column; p; p = end ? end + 1 : NULL) {
+		end = strchr(p, ';');
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (!strncasecmp(p, value, len)) {
+			const char *rest = p + len;
+			while (*rest == ' ' || *rest == '\t')
+				rest++;
+			if (rest == end || (!end && !*rest))
+				return true;
+		}
+	}
+
+	return false;
+}
+
+
+
+static inline int _fold(int c)
+{
+	/* SQLite folds ASCII letters only */
+	return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+
+
+static inline const char *_next_char(const char *str)
+{
+	/* '_' matches a whole UTF-8 character */
+	str++;
+	while ((*str & 0xC0) == 0x80)
+		str++;
+
+	return str;
+}
+
+
+
+static bool _like(const char *str, const char *pattern);
+
+/* pattern matches the start of str, as in like 'pattern%' */
+static bool _like_at(const char *str, const char *pattern)
+{
+	for (; *pattern; pattern++) {
+		if (*pattern == '%') {
+			while (*pattern == '%')
+				pattern++;
+			return _like(str, pattern);
+		}
+
+		if (!*str)
+			return false;
+
+		if (*pattern == '_') {
+			str = _next_char(str);
+			continue;
+		}
+
+		if (_fold((unsigned char)*pattern) != _fold((unsigned char)*str))
+			return false;
+		str++;
+	}
+
+	return true;
+}
+
+
+
+/* pattern matches anywhere in str, as in like '%pattern%' */
+static bool _like(const char *str, const char *pattern)
+{
+	for (;; str = _next_char(str)) {
+		if (_like_at(str, pattern))
+			return true;
+		if (!*str)
+			return false;
+	}
+}
+
+
+
+static bool _match_str(int prop, const char *column, const char *value)
+{
+	/* Mirror the SQL filters : list columns match one entry, case insensitive */
+	if (sql_get_list_field(prop))
+		return _match_token(column, value);
+
+	/* 'like' conditions : '%' and '_' in value are wildcards too */
+	if (strstr(sql_get_filter(prop), " like "))
+		return _like(column, value);
+
+	return strcmp(column, value) == 0;
+}
+
+
+
+static bool _match(char **values, GSList *conds)
+{
+	struct element *e;
+	const char *v;
+	GSList *l;
+	int t;
+
+	for (l = conds; l; l = g_slist_next(l)) {
+		e = l->data;
+		v = values[e->prop];
+		if (!v)
+			return false;
+
+		ELEMENT_TYPE(e, t);
+		switch (t) {
+			case VAL_TYPE_BOOL:
+				if (atoi(v) != (int)ELEMENT_BOOL(e)->value)
+					return false;
+				break;
+			case VAL_TYPE_INT:
+				if (atoi(v) != ELEMENT_INT(e)->value)
+					return false;
+				break;
+			case VAL_TYPE_STR:
+				if (!_match_str(e->prop, v, ELEMENT_STR(e)->value))
+					return false;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+static const struct snapshot_row *_find(const struct snapshot *s, int prop, const char *key)
+{
+	const struct snapshot_row *row;
+	uint32_t lo, hi, mid, n;
+	const char *v;
+	int cmp;
+
+	n = (E_AIL_PROP_PACKAGE_STR == prop) ? s->hdr->n_rows : s->hdr->n_appids;
+	lo = 0;
+	hi = n;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (E_AIL_PROP_PACKAGE_STR == prop) {
+			row = &s->rows[mid];
+		} else {
+			if (s->appids[mid] >= s->hdr->n_rows)
+				return NULL;
+			row = &s->rows[s->appids[mid]];
+		}
+
+		v = _str(s, row->values[prop]);
+		if (!v)
+			return NULL;
+
+		cmp = strcmp(key, v);
+		if (cmp == 0)
+			return row;
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return NULL;
+}
+
+
+
+ail_error_e snapshot_get_appinfo(int prop, const char *key, char ***values)
+{
+	const struct snapshot_row *row;
+	char *row_values[NUM_OF_PROP];
+	struct snapshot *s;
+	char *locale;
+	char **dup;
+	int i;
+
+	retv_if(!key, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(!values, AIL_ERROR_INVALID_PARAMETER);
+	retv_if(prop != E_AIL_PROP_PACKAGE_STR && prop != E_AIL_PROP_X_SLP_APPID_STR,
+			AIL_ERROR_INVALID_PARAMETER);
+
+	s = _get();
+	if (!s)
+		return AIL_ERROR_FAIL;
+
+	row = _find(s, prop, key);
+	if (!row) {
+		_put(s);
+		return AIL_ERROR_NO_DATA;
+	}
+
+	locale = sql_get_locale();
+	_row_values(s, row, locale, row_values);
+	SAFE_FREE(locale);
+
+	dup = calloc(NUM_OF_PROP, sizeof(char *));
+	if (!dup) {
+		_put(s);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	for (i = 0; i < NUM_OF_PROP; i++) {
+		if (!row_values[i])
+			continue;
+
+		dup[i] = strdup(row_values[i]);
+		if (!dup[i]) {
+			while (--i >= 0)
+				SAFE_FREE(dup[i]);
+			free(dup);
+			_put(s);
+			return AIL_ERROR_OUT_OF_MEMORY;
+		}
+	}
+
+	_put(s);
+	*values = dup;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+ail_error_e snapshot_count(GSList *conds, int *cnt)
+{
+	char *values[NUM_OF_PROP];
+	struct snapshot *s;
+	char *locale;
+	uint32_t i;
+	int n = 0;
+
+	retv_if(!cnt, AIL_ERROR_INVALID_PARAMETER);
+
+	s = _get();
+	if (!s)
+		return AIL_ERROR_FAIL;
+
+	locale = sql_get_locale();
+	for (i = 0; i < s->hdr->n_rows; i++) {
+		_row_values(s, &s->rows[i], locale, values);
+		if (_match(values, conds))
+			n++;
+	}
+	SAFE_FREE(locale);
+
+	_put(s);
+	*cnt = n;
+
+	return AIL_ERROR_OK;
+}
+
+
+
+ail_error_e snapshot_foreach(GSList *conds, ail_list_appinfo_cb cb, void *user_data)
+{
+	char *values[NUM_OF_PROP];
+	struct snapshot *s;
+	ail_appinfo_h ai;
+	char *locale;
+	uint32_t i;
+
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+
+	s = _get();
+	if (!s)
+		return AIL_ERROR_FAIL;
+
+	ai = appinfo_create();
+	if (!ai) {
+		_put(s);
+		return AIL_ERROR_OUT_OF_MEMORY;
+	}
+
+	locale = sql_get_locale();
+	appinfo_set_values(ai, values);
+	for (i = 0; i < s->hdr->n_rows; i++) {
+		_row_values(s, &s->rows[i], locale, values);
+		if (!_match(values, conds))
+			continue;
+
+		appinfo_next_row(ai);
+		if (cb(ai, user_data) == AIL_CB_RET_CANCEL)
+			break;
+	}
+	SAFE_FREE(locale);
+
+	appinfo_destroy(ai);
+	_put(s);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_snapshot_publish(void)
+{
+	return snapshot_publish();
+}
+
+
+
+EXPORT_API ail_error_e ail_snapshot_enable(void)
+{
+	pthread_mutex_lock(&reader.lock);
+	reader.enabled = true;
+	pthread_mutex_unlock(&reader.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_snapshot_disable(void)
+{
+	pthread_mutex_lock(&reader.lock);
+	reader.enabled = false;
+	_drop_current();
+	pthread_mutex_unlock(&reader.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+// End of file
@@ -0,0 +1,39 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+#ifndef __AIL_SNAPSHOT_H__
+#define __AIL_SNAPSHOT_H__
+
+#include <glib.h>
+#include "ail.h"
+
+ail_error_e snapshot_publish(void);
+void snapshot_republish(void);
+bool snapshot_withdraw(void);
+
+ail_error_e snapshot_get_appinfo(int prop, const char *key, char ***values);
+ail_error_e snapshot_count(GSList *conds, int *cnt);
+ail_error_e snapshot_foreach(GSList *conds, ail_list_appinfo_cb cb, void *user_data);
+
+#endif  /* __AIL_SNAPSHOT_H__ */
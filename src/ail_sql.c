@@ -36,15 +36,15 @@ static const char *filter[] = {
 	"((localname.name is NULL and app_info.name like '%%%s%%') or (localname.name like '%%%s%%'))",
 	"app_info.TYPE like '%%%s%%'",
 	"app_info.ICON='%s'",
-	"app_info.CATEGORIES like '%%%s%%'",
+	"app_info.PACKAGE in (select package from app_token where field='categories' and value='%s' COLLATE NOCASE)",
 	"app_info.VERSION='%s'",
-	"app_info.MIMETYPE like '%%%s%%'",
-	"app_info.X_SLP_SERVICE like '%%%s%%'",
+	"app_info.PACKAGE in (select package from app_token where field='mimetype' and value='%s' COLLATE NOCASE)",
+	"app_info.PACKAGE in (select package from app_token where field='x_slp_service' and value='%s' COLLATE NOCASE)",
 	"app_info.X_SLP_PACKAGETYPE='%s'",
-	"app_info.X_SLP_PACKAGECATEGORIES like '%%%s%%'",
+	"app_info.PACKAGE in (select package from app_token where field='x_slp_packagecategories' and value='%s' COLLATE NOCASE)",
 	"app_info.X_SLP_PACKAGEID='%s'",
 	"app_info.X_SLP_URI='%s'",
-	"app_info.X_SLP_SVC like '%%%s%%'",
+	"app_info.PACKAGE in (select package from app_token where field='x_slp_svc' and value='%s' COLLATE NOCASE)",
 	"app_info.X_SLP_EXE_PATH='%s'",
 	"app_info.X_SLP_APPID='%s'",
 	"app_info.X_SLP_BASELAYOUTWIDTH=%d",
@@ -59,6 +59,21 @@ static const char *filter[] = {
 };
 
 
+/* ';'-separated list columns, each entry is also stored in app_token */
+static const char *list_field[NUM_OF_PROP] = {
+	[E_AIL_PROP_CATEGORIES_STR] = "categories",
+	[E_AIL_PROP_MIMETYPE_STR] = "mimetype",
+	[E_AIL_PROP_X_SLP_SERVICE_STR] = "x_slp_service",
+	[E_AIL_PROP_X_SLP_PACKAGECATEGORIES_STR] = "x_slp_packagecategories",
+	[E_AIL_PROP_X_SLP_SVC_STR] = "x_slp_svc",
+};
+
+inline const char *sql_get_list_field(int prop)
+{
+	retv_if(prop < 0 || prop >= NUM_OF_PROP , NULL);
+	return list_field[prop];
+}
+
 inline const char *sql_get_filter(int prop)
 {
 	retv_if(prop < 0 || prop >= NUM_OF_PROP , NULL);
@@ -60,7 +60,29 @@
 #define SQL_FLD_APP_INFO_WITH_LOCALNAME SQL_FLD_APP_INFO",""localname.name"
 #define SQL_LOCALNAME_IDX NUM_OF_PROP + 0
 
+/* app_token field of the declared and the symlink-resolved executable paths */
+#define SQL_FIELD_EXE_PATH "exe_path"
+
+/* Name shown to the user, as ail_appinfo_get_str(NAME) returns it */
+#define SQL_DISPLAY_NAME "ifnull(localname.name, app_info.name)"
+
+/* MATCH expression, locale, MATCH expression */
+#define SQL_FLT_SEARCH "(app_info.package in (select package from app_name_fts " \
+			"where name match '%s' and locale='%s') or " \
+			"(localname.name is NULL and app_info.package in " \
+			"(select package from app_name_fts " \
+			"where name match '%s' and locale='')))"
+
+/* Without the name index, one word prefix of the shown name, lowercase */
+#define SQL_FLT_SEARCH_LIKE "(' ' || lower("SQL_DISPLAY_NAME")) like '%% %s%%'"
+
+/* Exact name first, then names starting with the terms, then other word prefix hits */
+#define SQL_ORD_SEARCH " order by case when lower("SQL_DISPLAY_NAME")='%s' then 0 " \
+			"when "SQL_DISPLAY_NAME" like '%s%%' then 1 else 2 end, " \
+			SQL_DISPLAY_NAME", app_info.package"
+
 const char *sql_get_filter(int prop);
+const char *sql_get_list_field(int prop);
 char *sql_get_locale();
 int sql_get_app_info_idx(int prop);
 
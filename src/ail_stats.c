@@ -0,0 +1,524 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <glib.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_stats.h"
+
+#define STATS_ACTIVE_MAX	16
+#define STATS_SHAPES_MAX	512
+#define STATS_BUCKETS		32
+#define STATS_SLOW_DEFAULT	100
+#define STATS_OTHER		"(other)"
+/* Milliseconds to wait for a lock, as long as the handler of db-util which this one replaces */
+#define STATS_BUSY_TIMEOUT	5000
+/* Set to 1 to count lock waits, which replaces the busy handler of db-util */
+#define STATS_BUSY_ENV		"AIL_DB_BUSY_STATS"
+
+struct shape {
+	unsigned long count;
+	unsigned long long rows;
+	unsigned long long total_ns;
+	unsigned long long max_ns;
+	unsigned long buckets[STATS_BUCKETS];	/* bucket i counts latencies under 2^i us */
+};
+
+static struct {
+	pthread_mutex_t lock;
+	GHashTable *shapes;	/* normalized SQL to struct shape */
+	int slow_ms;		/* -1 until AIL_DB_SLOW_QUERY_MS is read */
+} stats = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.shapes = NULL,
+	.slow_ms = -1,
+};
+
+/* Updated with atomics, the handler runs on every thread */
+static struct {
+	unsigned long waits;
+	unsigned long retries;
+	unsigned long long wait_us;
+	unsigned long timeouts;
+} busy;
+
+/* The backoff of sqlite3_busy_timeout(), in ms */
+static const int busy_delays[] = { 1, 2, 5, 10, 15, 20, 25, 25, 25, 50, 50, 100 };
+
+/* Statements of this thread between db_prepare() and db_finalize() */
+static __thread struct {
+	sqlite3_stmt *stmt;
+	unsigned long long ns;
+	unsigned long long rows;
+	bool stepped;
+} active[STATS_ACTIVE_MAX];
+
+
+
+unsigned long long stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+
+static int _find(sqlite3_stmt *stmt)
+{
+	int i;
+
+	for (i = 0; i < STATS_ACTIVE_MAX; i++) {
+		if (active[i].stmt == stmt)
+			return i;
+	}
+
+	return -1;
+}
+
+
+
+/* Literals become ?, lists of them a single ? and blanks a single space */
+static char *_normalize(const char *sql)
+{
+	GString *shape;
+	const char *p = sql;
+	bool word = false;
+	gsize len;
+
+	shape = g_string_sized_new(strlen(sql));
+
+	while (*p) {
+		if (*p == '\'' || *p == '?' || (!word && *p >= '0' && *p <= '9')) {
+			if (*p == '\'') {
+				for (p++; *p && (*p != '\'' || *(p + 1) == '\''); p++) {
+					if (*p == '\'')
+						p++;
+				}
+				if (*p)
+					p++;
+			} else if (*p == '?') {
+				p++;
+			} else {
+				while ((*p >= '0' && *p <= '9') || *p == '.')
+					p++;
+			}
+
+			/* A ? following another one is part of a list */
+			len = shape->len;
+			while (len && (shape->str[len - 1] == ' ' || shape->str[len - 1] == ','))
+				len--;
+			if (len && shape->str[len - 1] == '?')
+				g_string_truncate(shape, len);
+			else
+				g_string_append_c(shape, '?');
+			word = false;
+			continue;
+		}
+
+		if (*p == ' ' || *p == '\t' || *p == '\n') {
+			if (shape->len && shape->str[shape->len - 1] != ' ')
+				g_string_append_c(shape, ' ');
+			word = false;
+		} else {
+			g_string_append_c(shape, *p);
+			word = g_ascii_isalnum(*p) || *p == '_';
+		}
+		p++;
+	}
+
+	return g_string_free(shape, FALSE);
+}
+
+
+
+static void _explain(sqlite3 *db, const char *sql)
+{
+	sqlite3_stmt *stmt;
+	char *query;
+
+	query = sqlite3_mprintf("EXPLAIN QUERY PLAN %s", sql);
+	if (!query)
+		return;
+
+	if (sqlite3_prepare_v2(db, query, -1, &stmt, NULL) == SQLITE_OK) {
+		while (sqlite3_step(stmt) == SQLITE_ROW)
+			_E("  %s", (const char *)sqlite3_column_text(stmt, 3));
+		sqlite3_finalize(stmt);
+	}
+
+	sqlite3_free(query);
+}
+
+
+
+/* Must be called with stats.lock held */
+static int _slow_threshold(void)
+{
+	const char *value;
+
+	if (stats.slow_ms < 0) {
+		value = getenv("AIL_DB_SLOW_QUERY_MS");
+		stats.slow_ms = value ? atoi(value) : STATS_SLOW_DEFAULT;
+		if (stats.slow_ms < 0)
+			stats.slow_ms = 0;
+	}
+
+	return stats.slow_ms;
+}
+
+
+
+static void _record(sqlite3 *db, const char *sql, unsigned long long ns, unsigned long long rows)
+{
+	struct shape *s;
+	char *key;
+	unsigned long long us = ns / 1000;
+	int bucket = 0;
+	int slow_ms;
+
+	if (!sql)
+		return;
+
+	key = _normalize(sql);
+
+	while (bucket < STATS_BUCKETS - 1 && us >= (1ULL << bucket))
+		bucket++;
+
+	pthread_mutex_lock(&stats.lock);
+
+	if (!stats.shapes)
+		stats.shapes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free);
+
+	s = g_hash_table_lookup(stats.shapes, key);
+	if (!s && g_hash_table_size(stats.shapes) >= STATS_SHAPES_MAX) {
+		g_free(key);
+		key = g_strdup(STATS_OTHER);
+		s = g_hash_table_lookup(stats.shapes, key);
+	}
+	if (!s) {
+		s = calloc(1, sizeof(struct shape));
+		if (s) {
+			g_hash_table_insert(stats.shapes, key, s);
+			key = NULL;
+		}
+	}
+
+	if (s) {
+		s->count++;
+		s->rows += rows;
+		s->total_ns += ns;
+		if (ns > s->max_ns)
+			s->max_ns = ns;
+		s->buckets[bucket]++;
+	}
+
+	slow_ms = _slow_threshold();
+
+	pthread_mutex_unlock(&stats.lock);
+
+	g_free(key);
+
+	if (slow_ms && ns >= slow_ms * 1000000ULL) {
+		_E("Slow query, %llu ms: %s", ns / 1000000, sql);
+		_explain(db, sql);
+	}
+}
+
+
+
+void stats_start(sqlite3_stmt *stmt, unsigned long long elapsed)
+{
+	int i;
+
+	i = _find(stmt);
+	if (i < 0)
+		i = _find(NULL);
+	if (i < 0)
+		return;
+
+	active[i].stmt = stmt;
+	active[i].ns = elapsed;
+	active[i].rows = 0;
+	active[i].stepped = false;
+}
+
+
+
+void stats_step(sqlite3_stmt *stmt, unsigned long long elapsed, bool row)
+{
+	int i;
+
+	i = _find(stmt);
+	if (i < 0)
+		return;
+
+	active[i].ns += elapsed;
+	active[i].rows += row ? 1 : 0;
+	active[i].stepped = true;
+}
+
+
+
+/* The connection of stmt must still be usable, for the plan of a slow query */
+void stats_end(sqlite3_stmt *stmt, bool reuse)
+{
+	int i;
+
+	i = _find(stmt);
+	if (i < 0)
+		return;
+
+	if (active[i].stepped)
+		_record(sqlite3_db_handle(stmt), sqlite3_sql(stmt), active[i].ns, active[i].rows);
+
+	active[i].ns = 0;
+	active[i].rows = 0;
+	active[i].stepped = false;
+	if (!reuse)
+		active[i].stmt = NULL;
+}
+
+
+
+void stats_exec(sqlite3 *db, const char *query, unsigned long long elapsed)
+{
+	_record(db, query, elapsed, 0);
+}
+
+
+
+static int _busy_handler(void *data, int count)
+{
+	int n = sizeof(busy_delays) / sizeof(busy_delays[0]);
+	int delay;
+	int prior = 0;
+	int i;
+	unsigned long long start;
+
+	for (i = 0; i < count && i < n; i++)
+		prior += busy_delays[i];
+	if (count > n)
+		prior += (count - n) * busy_delays[n - 1];
+	delay = busy_delays[count < n ? count : n - 1];
+
+	if (!count)
+		__atomic_add_fetch(&busy.waits, 1, __ATOMIC_RELAXED);
+
+	if (prior + delay > STATS_BUSY_TIMEOUT)
+		delay = STATS_BUSY_TIMEOUT - prior;
+	if (delay <= 0) {
+		__atomic_add_fetch(&busy.timeouts, 1, __ATOMIC_RELAXED);
+		return 0;
+	}
+
+	start = stats_now();
+	usleep(delay * 1000);
+	__atomic_add_fetch(&busy.retries, 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&busy.wait_us, (stats_now() - start) / 1000, __ATOMIC_RELAXED);
+
+	return 1;
+}
+
+
+
+/* Other processes keep the busy handler of db-util, SQLite cannot chain to it */
+void stats_watch_busy(sqlite3 *db)
+{
+	static int enabled = -1;
+	const char *value;
+	int on;
+
+	on = __atomic_load_n(&enabled, __ATOMIC_RELAXED);
+	if (on < 0) {
+		value = getenv(STATS_BUSY_ENV);
+		on = value && atoi(value) > 0;
+		__atomic_store_n(&enabled, on, __ATOMIC_RELAXED);
+	}
+
+	if (on)
+		sqlite3_busy_handler(db, _busy_handler, NULL);
+}
+
+
+
+/* Upper bound of the bucket holding the given percentile, no more than the maximum */
+static unsigned long long _percentile(const struct shape *s, int percent)
+{
+	unsigned long long rank;
+	unsigned long long seen = 0;
+	int i;
+
+	rank = (s->count * percent + 99) / 100;
+
+	for (i = 0; i < STATS_BUCKETS; i++) {
+		seen += s->buckets[i];
+		if (seen >= rank)
+			break;
+	}
+
+	return MIN(1ULL << i, s->max_ns / 1000);
+}
+
+
+
+static gint _by_total(gconstpointer a, gconstpointer b)
+{
+	const ail_query_stats_s *sa = a;
+	const ail_query_stats_s *sb = b;
+
+	if (sa->total_us == sb->total_us)
+		return 0;
+
+	return sa->total_us < sb->total_us ? 1 : -1;
+}
+
+
+
+EXPORT_API ail_error_e ail_stats_get(ail_stats_cb cb, void *user_data)
+{
+	GArray *list;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	ail_query_stats_s qs;
+	struct shape *s;
+	int i;
+
+	retv_if(!cb, AIL_ERROR_INVALID_PARAMETER);
+
+	list = g_array_new(FALSE, FALSE, sizeof(ail_query_stats_s));
+	retv_if(!list, AIL_ERROR_OUT_OF_MEMORY);
+
+	pthread_mutex_lock(&stats.lock);
+	if (stats.shapes) {
+		g_hash_table_iter_init(&iter, stats.shapes);
+		while (g_hash_table_iter_next(&iter, &key, &value)) {
+			s = value;
+			qs.query = g_strdup(key);
+			qs.count = s->count;
+			qs.rows = s->rows;
+			qs.total_us = s->total_ns / 1000;
+			qs.max_us = s->max_ns / 1000;
+			qs.p50_us = _percentile(s, 50);
+			qs.p90_us = _percentile(s, 90);
+			qs.p99_us = _percentile(s, 99);
+			g_array_append_val(list, qs);
+		}
+	}
+	pthread_mutex_unlock(&stats.lock);
+
+	g_array_sort(list, _by_total);
+
+	for (i = 0; i < list->len; i++) {
+		if (cb(&g_array_index(list, ail_query_stats_s, i), user_data) == AIL_CB_RET_CANCEL)
+			break;
+	}
+
+	for (i = 0; i < list->len; i++)
+		g_free((char *)g_array_index(list, ail_query_stats_s, i).query);
+	g_array_free(list, TRUE);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+static ail_cb_ret_e _dump_cb(const ail_query_stats_s *qs, void *user_data)
+{
+	int fd = *(int *)user_data;
+
+	dprintf(fd, "%8lu %10llu %12llu %10llu %10llu %10llu %10llu  %s\n",
+			qs->count, qs->rows, qs->total_us, qs->p50_us, qs->p90_us, qs->p99_us, qs->max_us, qs->query);
+
+	return AIL_CB_RET_CONTINUE;
+}
+
+
+
+EXPORT_API ail_error_e ail_stats_dump(int fd)
+{
+	retv_if(fd < 0, AIL_ERROR_INVALID_PARAMETER);
+
+	dprintf(fd, "%8s %10s %12s %10s %10s %10s %10s  %s\n",
+			"count", "rows", "total_us", "p50_us", "p90_us", "p99_us", "max_us", "query");
+
+	return ail_stats_get(_dump_cb, &fd);
+}
+
+
+
+EXPORT_API ail_error_e ail_stats_reset(void)
+{
+	pthread_mutex_lock(&stats.lock);
+	if (stats.shapes)
+		g_hash_table_remove_all(stats.shapes);
+	pthread_mutex_unlock(&stats.lock);
+
+	__atomic_store_n(&busy.waits, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&busy.retries, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&busy.wait_us, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&busy.timeouts, 0, __ATOMIC_RELAXED);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_stats_get_busy(ail_busy_stats_s *stats)
+{
+	retv_if(!stats, AIL_ERROR_INVALID_PARAMETER);
+
+	stats->waits = __atomic_load_n(&busy.waits, __ATOMIC_RELAXED);
+	stats->retries = __atomic_load_n(&busy.retries, __ATOMIC_RELAXED);
+	stats->wait_us = __atomic_load_n(&busy.wait_us, __ATOMIC_RELAXED);
+	stats->timeouts = __atomic_load_n(&busy.timeouts, __ATOMIC_RELAXED);
+
+	return AIL_ERROR_OK;
+}
+
+
+
+EXPORT_API ail_error_e ail_stats_set_slow_threshold(int ms)
+{
+	retv_if(ms < 0, AIL_ERROR_INVALID_PARAMETER);
+
+	pthread_mutex_lock(&stats.lock);
+	stats.slow_ms = ms;
+	pthread_mutex_unlock(&stats.lock);
+
+	return AIL_ERROR_OK;
+}
+
+
+// End of file.
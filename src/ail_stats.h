@@ -0,0 +1,40 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#ifndef __AIL_STATS_H__
+#define __AIL_STATS_H__
+
+#include <stdbool.h>
+#include <sqlite3.h>
+
+unsigned long long stats_now(void);
+void stats_start(sqlite3_stmt *stmt, unsigned long long elapsed);
+void stats_step(sqlite3_stmt *stmt, unsigned long long elapsed, bool row);
+void stats_end(sqlite3_stmt *stmt, bool reuse);
+void stats_exec(sqlite3 *db, const char *query, unsigned long long elapsed);
+void stats_watch_busy(sqlite3 *db);
+
+#endif  /* __AIL_STATS_H__ */
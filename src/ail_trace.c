@@ -0,0 +1,73 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+#include <stdlib.h>
+#include "ail.h"
+#include "ail_private.h"
+#include "ail_trace.h"
+
+int trace_enabled;
+
+struct hook {
+	ail_trace_cb cb;
+	void *user_data;
+};
+
+/* Never freed, a thread may still be calling a replaced hook */
+static struct hook *hook;
+
+
+
+void trace_fire(ail_trace_point_e point, ail_trace_phase_e phase, const char *detail)
+{
+	struct hook *h;
+
+	h = __atomic_load_n(&hook, __ATOMIC_ACQUIRE);
+	if (h)
+		h->cb(point, phase, detail, h->user_data);
+}
+
+
+
+EXPORT_API ail_error_e ail_trace_set_hook(ail_trace_cb cb, void *user_data)
+{
+	struct hook *h = NULL;
+
+	if (cb) {
+		h = malloc(sizeof(struct hook));
+		retv_if(!h, AIL_ERROR_OUT_OF_MEMORY);
+		h->cb = cb;
+		h->user_data = user_data;
+	}
+
+	/* cb and user_data are seen together, or not at all */
+	__atomic_store_n(&hook, h, __ATOMIC_RELEASE);
+	__atomic_store_n(&trace_enabled, h ? 1 : 0, __ATOMIC_RELEASE);
+
+	return AIL_ERROR_OK;
+}
+
+
+// End of file.
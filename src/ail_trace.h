@@ -0,0 +1,47 @@
+/*
+ * ail
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Jayoun Lee <airjany@samsung.com>, Sewook Park <sewook7.park@samsung.com>, Jaeho Lee <jaeho81.lee@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+
+
+
+
+#ifndef __AIL_TRACE_H__
+#define __AIL_TRACE_H__
+
+#include "ail.h"
+
+extern int trace_enabled;
+
+void trace_fire(ail_trace_point_e point, ail_trace_phase_e phase, const char *detail);
+
+/* detail is only evaluated while a hook is set */
+#define TRACE_BEGIN(point, detail) do { \
+	if (__builtin_expect(__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED), 0)) \
+		trace_fire(point, AIL_TRACE_BEGIN, detail); \
+} while (0)
+
+#define TRACE_END(point, detail) do { \
+	if (__builtin_expect(__atomic_load_n(&trace_enabled, __ATOMIC_RELAXED), 0)) \
+		trace_fire(point, AIL_TRACE_END, detail); \
+} while (0)
+
+#endif  /* __AIL_TRACE_H__ */